@@ -4,7 +4,13 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <raylib.h>
+#include <raymath.h>
 #include <time.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "pong_bench.h"   // --bench frame statistics and draw call counting, after raylib.h
+#include "pong_quality.h" // Effect tiers picked from recent frame times
 
 // Game constants
 #define SCREEN_WIDTH 800
@@ -45,203 +51,231 @@ typedef struct {
 // Global game state
 GameState gameState;
 
-// Thread function to update ball movement
-void* ballThreadFunc(void* arg) {
-    while (1) {
-        // Sleep to control update rate
-        usleep(16000); // ~60 updates per second
+// Set on exit so the worker threads return and can be joined
+atomic_bool threadsDone;
+
+// Loaded once in main before the threads start; left empty (silent) with --bench
+Sound paddleHitSound, wallHitSound, scoreSound;
+
+// Trail, paddle corners and overlays follow the frame times unless --quality pins them (main thread only)
+PongQuality quality;
+
+// F3 shows the quality tier, frame budget and frame work
+bool showTelemetry = false;
+
+// Advance the ball one tick: walls, paddles and scoring (caller holds stateMutex)
+void updateBall() {
+    if (gameState.gameOver || gameState.gamePaused) {
+        return;
+    }
+    
+    // Update ball position
+    gameState.ballPosition.x += gameState.ballVelocity.x;
+    gameState.ballPosition.y += gameState.ballVelocity.y;
+    
+    // Ball collision with top and bottom walls
+    if (gameState.ballPosition.y <= 0 || gameState.ballPosition.y >= SCREEN_HEIGHT) {
+        gameState.ballVelocity.y *= -1.0f;
+        PlaySound(wallHitSound);
         
-        pthread_mutex_lock(&gameState.stateMutex);
+        // Ensure ball stays within bounds
+        if (gameState.ballPosition.y < 0) gameState.ballPosition.y = 0;
+        if (gameState.ballPosition.y > SCREEN_HEIGHT) gameState.ballPosition.y = SCREEN_HEIGHT;
+    }
+    
+    // Ball collision with paddles
+    if (gameState.ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
+        gameState.ballPosition.y >= gameState.leftPaddleY && 
+        gameState.ballPosition.y <= gameState.leftPaddleY + PADDLE_HEIGHT) {
         
-        if (gameState.gameOver || gameState.gamePaused) {
-            pthread_mutex_unlock(&gameState.stateMutex);
-            continue;
-        }
+        // Calculate reflection angle based on where ball hits paddle
+        float hitPosition = (gameState.ballPosition.y - gameState.leftPaddleY) / PADDLE_HEIGHT;
+        float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
         
-        // Update ball position
-        gameState.ballPosition.x += gameState.ballVelocity.x;
-        gameState.ballPosition.y += gameState.ballVelocity.y;
+        // Increase ball speed slightly with each hit
+        float speed = Vector2Length(gameState.ballVelocity);
+        if (speed < MAX_BALL_SPEED) speed *= 1.1f;  // Increased speed multiplier from 1.05f
         
-        // Ball collision with top and bottom walls
-        if (gameState.ballPosition.y <= 0 || gameState.ballPosition.y >= SCREEN_HEIGHT) {
-            gameState.ballVelocity.y *= -1.0f;
-            PlaySound(LoadSound("resources/wall_hit.wav"));
-            
-            // Ensure ball stays within bounds
-            if (gameState.ballPosition.y < 0) gameState.ballPosition.y = 0;
-            if (gameState.ballPosition.y > SCREEN_HEIGHT) gameState.ballPosition.y = SCREEN_HEIGHT;
-        }
+        // Apply level-based speed bonus
+        speed *= (1.0f + (gameState.level - 1) * 0.3f);  // Significant speed difference between levels
         
-        // Ball collision with paddles
-        if (gameState.ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.leftPaddleY && 
-            gameState.ballPosition.y <= gameState.leftPaddleY + PADDLE_HEIGHT) {
-            
-            // Calculate reflection angle based on where ball hits paddle
-            float hitPosition = (gameState.ballPosition.y - gameState.leftPaddleY) / PADDLE_HEIGHT;
-            float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
-            
-            // Increase ball speed slightly with each hit
-            float speed = Vector2Length(gameState.ballVelocity);
-            if (speed < MAX_BALL_SPEED) speed *= 1.1f;  // Increased speed multiplier from 1.05f
-            
-            // Apply level-based speed bonus
-            speed *= (1.0f + (gameState.level - 1) * 0.3f);  // Significant speed difference between levels
-            
-            // Set new velocity
-            gameState.ballVelocity.x = speed * cosf(bounceAngle);
-            gameState.ballVelocity.y = speed * sinf(bounceAngle);
-            
-            // Ensure ball moves right
-            if (gameState.ballVelocity.x < 0) gameState.ballVelocity.x *= -1;
-            
-            // Move ball outside paddle to prevent multiple collisions
-            gameState.ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;
-            
-            // Play sound
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
-        }
+        // Set new velocity
+        gameState.ballVelocity.x = speed * cosf(bounceAngle);
+        gameState.ballVelocity.y = speed * sinf(bounceAngle);
         
-        if (gameState.ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.rightPaddleY && 
-            gameState.ballPosition.y <= gameState.rightPaddleY + PADDLE_HEIGHT) {
-            
-            // Calculate reflection angle based on where ball hits paddle
-            float hitPosition = (gameState.ballPosition.y - gameState.rightPaddleY) / PADDLE_HEIGHT;
-            float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
-            
-            // Increase ball speed slightly with each hit
-            float speed = Vector2Length(gameState.ballVelocity);
-            if (speed < MAX_BALL_SPEED) speed *= 1.1f;  // Increased speed multiplier from 1.05f
-            
-            // Apply level-based speed bonus
-            speed *= (1.0f + (gameState.level - 1) * 0.3f);  // Significant speed difference between levels
-            
-            // Set new velocity
-            gameState.ballVelocity.x = speed * cosf(bounceAngle);
-            gameState.ballVelocity.y = speed * sinf(bounceAngle);
-            
-            // Ensure ball moves left
-            if (gameState.ballVelocity.x > 0) gameState.ballVelocity.x *= -1;
-            
-            // Move ball outside paddle to prevent multiple collisions
-            gameState.ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
-            
-            // Play sound
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
-        }
+        // Ensure ball moves right
+        if (gameState.ballVelocity.x < 0) gameState.ballVelocity.x *= -1;
         
-        // Scoring
-        if (gameState.ballPosition.x < 0) {
-            // Right player scores
-            gameState.rightScore++;
-            PlaySound(LoadSound("resources/score.wav"));
-            
-            // Reset ball with level-based speed
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            
-            // Level-specific initial ball speed (much more pronounced differences)
-            float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;  // Level 1: 1.0x, Level 2: 1.5x, Level 3: 2.0x
-            gameState.ballVelocity.x = INITIAL_BALL_SPEED * levelSpeedMultiplier;
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
-                                      (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
-            
-            // Check for game over
-            if (gameState.rightScore >= MAX_SCORE) {
-                gameState.gameOver = true;
-            }
+        // Move ball outside paddle to prevent multiple collisions
+        gameState.ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;
+        
+        // Play sound
+        PlaySound(paddleHitSound);
+    }
+    
+    if (gameState.ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
+        gameState.ballPosition.y >= gameState.rightPaddleY && 
+        gameState.ballPosition.y <= gameState.rightPaddleY + PADDLE_HEIGHT) {
+        
+        // Calculate reflection angle based on where ball hits paddle
+        float hitPosition = (gameState.ballPosition.y - gameState.rightPaddleY) / PADDLE_HEIGHT;
+        float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
+        
+        // Increase ball speed slightly with each hit
+        float speed = Vector2Length(gameState.ballVelocity);
+        if (speed < MAX_BALL_SPEED) speed *= 1.1f;  // Increased speed multiplier from 1.05f
+        
+        // Apply level-based speed bonus
+        speed *= (1.0f + (gameState.level - 1) * 0.3f);  // Significant speed difference between levels
+        
+        // Set new velocity
+        gameState.ballVelocity.x = speed * cosf(bounceAngle);
+        gameState.ballVelocity.y = speed * sinf(bounceAngle);
+        
+        // Ensure ball moves left
+        if (gameState.ballVelocity.x > 0) gameState.ballVelocity.x *= -1;
+        
+        // Move ball outside paddle to prevent multiple collisions
+        gameState.ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
+        
+        // Play sound
+        PlaySound(paddleHitSound);
+    }
+    
+    // Scoring
+    if (gameState.ballPosition.x < 0) {
+        // Right player scores
+        gameState.rightScore++;
+        PlaySound(scoreSound);
+        
+        // Reset ball with level-based speed
+        gameState.ballPosition.x = SCREEN_WIDTH / 2;
+        gameState.ballPosition.y = SCREEN_HEIGHT / 2;
+        
+        // Level-specific initial ball speed (much more pronounced differences)
+        float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;  // Level 1: 1.0x, Level 2: 1.5x, Level 3: 2.0x
+        gameState.ballVelocity.x = INITIAL_BALL_SPEED * levelSpeedMultiplier;
+        gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
+                                  (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
+        
+        // Check for game over
+        if (gameState.rightScore >= MAX_SCORE) {
+            gameState.gameOver = true;
         }
+    }
+    
+    if (gameState.ballPosition.x > SCREEN_WIDTH) {
+        // Left player scores
+        gameState.leftScore++;
+        PlaySound(scoreSound);
         
-        if (gameState.ballPosition.x > SCREEN_WIDTH) {
-            // Left player scores
-            gameState.leftScore++;
-            PlaySound(LoadSound("resources/score.wav"));
-            
-            // Reset ball with level-based speed
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            
-            // Level-specific initial ball speed (much more pronounced differences)
-            float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;  // Level 1: 1.0x, Level 2: 1.5x, Level 3: 2.0x
-            gameState.ballVelocity.x = -INITIAL_BALL_SPEED * levelSpeedMultiplier;
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
-                                      (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
-            
-            // Check for game over
-            if (gameState.leftScore >= MAX_SCORE) {
-                gameState.gameOver = true;
-            }
+        // Reset ball with level-based speed
+        gameState.ballPosition.x = SCREEN_WIDTH / 2;
+        gameState.ballPosition.y = SCREEN_HEIGHT / 2;
+        
+        // Level-specific initial ball speed (much more pronounced differences)
+        float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;  // Level 1: 1.0x, Level 2: 1.5x, Level 3: 2.0x
+        gameState.ballVelocity.x = -INITIAL_BALL_SPEED * levelSpeedMultiplier;
+        gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
+                                  (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
+        
+        // Check for game over
+        if (gameState.leftScore >= MAX_SCORE) {
+            gameState.gameOver = true;
         }
+    }
+}
+
+// Thread function to update ball movement
+void* ballThreadFunc(void* arg) {
+    while (!atomic_load(&threadsDone)) {
+        // Sleep to control update rate
+        usleep(16000); // ~60 updates per second
         
+        pthread_mutex_lock(&gameState.stateMutex);
+        updateBall();
         pthread_mutex_unlock(&gameState.stateMutex);
     }
     
     return NULL;
 }
 
-// Thread function for AI (right paddle)
-void* aiThreadFunc(void* arg) {
-    while (1) {
-        // Sleep to control update rate and add some "thinking time"
-        usleep(16000); // ~60 updates per second
-        
-        pthread_mutex_lock(&gameState.stateMutex);
-        
-        if (gameState.gameOver || gameState.gamePaused) {
-            pthread_mutex_unlock(&gameState.stateMutex);
-            continue;
-        }
-        
-        // Adjust AI difficulty based on level - Much more dramatic differences
-        float difficultyFactor = 0.4f + (gameState.level * 0.25f); // Level 1: 0.65, Level 2: 0.9, Level 3: 1.15
+// One AI decision for the right paddle (caller holds stateMutex)
+void updateAi() {
+    if (gameState.gameOver || gameState.gamePaused) {
+        return;
+    }
+    
+    // Adjust AI difficulty based on level - Much more dramatic differences
+    float difficultyFactor = 0.4f + (gameState.level * 0.25f); // Level 1: 0.65, Level 2: 0.9, Level 3: 1.15
+    
+    // Basic AI: move toward the ball with some prediction and reaction time
+    if (gameState.ballVelocity.x > 0) { // Only move if ball is coming toward AI
+        // Target position is where the ball will be
+        float targetY = gameState.ballPosition.y;
         
-        // Basic AI: move toward the ball with some prediction and reaction time
-        if (gameState.ballVelocity.x > 0) { // Only move if ball is coming toward AI
-            // Target position is where the ball will be
-            float targetY = gameState.ballPosition.y;
+        // Add prediction capability based on level
+        if (gameState.level > 1) {
+            // Calculate where ball will be when it reaches the paddle
+            float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - gameState.ballPosition.x) / gameState.ballVelocity.x;
+            float predictedY = gameState.ballPosition.y + (gameState.ballVelocity.y * timeToReach);
             
-            // Add prediction capability based on level
-            if (gameState.level > 1) {
-                // Calculate where ball will be when it reaches the paddle
-                float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - gameState.ballPosition.x) / gameState.ballVelocity.x;
-                float predictedY = gameState.ballPosition.y + (gameState.ballVelocity.y * timeToReach);
-                
-                // Bounce calculation for prediction
-                while (predictedY < 0 || predictedY > SCREEN_HEIGHT) {
-                    if (predictedY < 0) predictedY = -predictedY;
-                    if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
-                }
-                
-                // Adjust target with prediction - higher levels have more accurate prediction
-                targetY = predictedY * difficultyFactor + gameState.ballPosition.y * (1 - difficultyFactor);
+            // Bounce calculation for prediction
+            while (predictedY < 0 || predictedY > SCREEN_HEIGHT) {
+                if (predictedY < 0) predictedY = -predictedY;
+                if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
             }
             
-            // Introduce error based on level - much more error at lower levels
-            float errorRange = (4.0f - gameState.level) * 25.0f;  // Level 1: 75, Level 2: 50, Level 3: 25
-            targetY += (GetRandomValue(-100, 100) / 100.0f) * errorRange;
-            
-            // Make the paddle move toward the target with level-appropriate speed
-            float aiSpeed = PADDLE_SPEED * (0.8f + gameState.level * 0.2f);  // Level-based speed
-            
-            if (targetY < gameState.rightPaddleY + PADDLE_HEIGHT/2 - 10) {
-                gameState.rightPaddleY -= aiSpeed * difficultyFactor;
-            } else if (targetY > gameState.rightPaddleY + PADDLE_HEIGHT/2 + 10) {
-                gameState.rightPaddleY += aiSpeed * difficultyFactor;
-            }
-        } else {
-            // If ball moving away, move toward center with less urgency
-            if (gameState.rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) {
-                gameState.rightPaddleY += PADDLE_SPEED * 0.5f;
-            } else if (gameState.rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) {
-                gameState.rightPaddleY -= PADDLE_SPEED * 0.5f;
-            }
+            // Adjust target with prediction - higher levels have more accurate prediction
+            targetY = predictedY * difficultyFactor + gameState.ballPosition.y * (1 - difficultyFactor);
         }
         
-        // Ensure paddle stays within screen bounds
-        if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
-        if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
+        // Introduce error based on level - much more error at lower levels
+        float errorRange = (4.0f - gameState.level) * 25.0f;  // Level 1: 75, Level 2: 50, Level 3: 25
+        targetY += (GetRandomValue(-100, 100) / 100.0f) * errorRange;
+        
+        // Make the paddle move toward the target with level-appropriate speed
+        float aiSpeed = PADDLE_SPEED * (0.8f + gameState.level * 0.2f);  // Level-based speed
+        
+        if (targetY < gameState.rightPaddleY + PADDLE_HEIGHT/2 - 10) {
+            gameState.rightPaddleY -= aiSpeed * difficultyFactor;
+        } else if (targetY > gameState.rightPaddleY + PADDLE_HEIGHT/2 + 10) {
+            gameState.rightPaddleY += aiSpeed * difficultyFactor;
+        }
+    } else {
+        // If ball moving away, move toward center with less urgency
+        if (gameState.rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) {
+            gameState.rightPaddleY += PADDLE_SPEED * 0.5f;
+        } else if (gameState.rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) {
+            gameState.rightPaddleY -= PADDLE_SPEED * 0.5f;
+        }
+    }
+    
+    // Ensure paddle stays within screen bounds
+    if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
+    if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
+}
+
+// Attract scene's left CPU (--bench): follows the ball when it comes this way, drifts back to the middle otherwise
+void updateAttractPaddle() {
+    float targetY = gameState.ballVelocity.x < 0 ? gameState.ballPosition.y : SCREEN_HEIGHT / 2;
+    if (targetY < gameState.leftPaddleY + PADDLE_HEIGHT/2 - 10) {
+        gameState.leftPaddleY -= PADDLE_SPEED * 0.8f;
+    } else if (targetY > gameState.leftPaddleY + PADDLE_HEIGHT/2 + 10) {
+        gameState.leftPaddleY += PADDLE_SPEED * 0.8f;
+    }
+    if (gameState.leftPaddleY < 0) gameState.leftPaddleY = 0;
+    if (gameState.leftPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.leftPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
+}
+
+// Thread function for AI (right paddle)
+void* aiThreadFunc(void* arg) {
+    while (!atomic_load(&threadsDone)) {
+        // Sleep to control update rate and add some "thinking time"
+        usleep(16000); // ~60 updates per second
         
+        pthread_mutex_lock(&gameState.stateMutex);
+        updateAi();
         pthread_mutex_unlock(&gameState.stateMutex);
         
         // Sleep based on AI reaction time and difficulty
@@ -274,12 +308,14 @@ void initializeGame() {
     gameState.gamePaused = false;
     
     gameState.level = 1; // Start at level 1
-    
-    pthread_mutex_init(&gameState.stateMutex, NULL);
 }
 
 // Draw game
 void drawGame() {
+    struct timespec workStart, workEnd;
+    clock_gettime(CLOCK_MONOTONIC, &workStart);
+    const PongQualityTier* tier = pongQualityTier(&quality);
+    
     BeginDrawing();
     
     // Background color changes based on level - more dramatic differences
@@ -323,9 +359,16 @@ void drawGame() {
             paddleColor = WHITE;
     }
     
-    // Draw paddles with level-specific colors
-    DrawRectangleRounded((Rectangle){0, gameState.leftPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT}, 0.3f, 8, paddleColor);
-    DrawRectangleRounded((Rectangle){SCREEN_WIDTH - PADDLE_WIDTH, gameState.rightPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT}, 0.3f, 8, paddleColor);
+    // Draw paddles with level-specific colors, rounded as far as the quality tier allows
+    Rectangle leftPaddle = {0, gameState.leftPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT};
+    Rectangle rightPaddle = {SCREEN_WIDTH - PADDLE_WIDTH, gameState.rightPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT};
+    if (tier->paddleSegments > 0) {
+        DrawRectangleRounded(leftPaddle, 0.3f, tier->paddleSegments, paddleColor);
+        DrawRectangleRounded(rightPaddle, 0.3f, tier->paddleSegments, paddleColor);
+    } else {
+        DrawRectangleRec(leftPaddle, paddleColor);
+        DrawRectangleRec(rightPaddle, paddleColor);
+    }
     
     // Level-specific ball color
     Color ballColor;
@@ -343,8 +386,8 @@ void drawGame() {
             ballColor = WHITE;
     }
     
-    // Draw ball with trail effect - longer trails for higher levels
-    int trailLength = 3 + gameState.level * 2;  // Level 1: 5, Level 2: 7, Level 3: 9
+    // Draw ball with trail effect - longer trails for higher levels, shorter on lower quality tiers
+    int trailLength = pongQualityTrail(&quality, 3 + gameState.level * 2);  // Level 1: 5, Level 2: 7, Level 3: 9
     for (int i = 0; i < trailLength; i++) {
         float alpha = 0.3f - (i * 0.03f);
         if (alpha > 0) {
@@ -385,8 +428,10 @@ void drawGame() {
             levelColor = GOLD;
     }
     
-    DrawRectangle(SCREEN_WIDTH/2 - MeasureText(levelText, 24)/2 - 10, 5, 
-                 MeasureText(levelText, 24) + 20, 30, Fade(BLACK, 0.7f));
+    if (tier->alphaOverlays) {
+        DrawRectangle(SCREEN_WIDTH/2 - MeasureText(levelText, 24)/2 - 10, 5, 
+                     MeasureText(levelText, 24) + 20, 30, Fade(BLACK, 0.7f));
+    }
     DrawText(levelText, SCREEN_WIDTH/2 - MeasureText(levelText, 24)/2, 10, 24, levelColor);
     
     // Draw game over message
@@ -395,7 +440,7 @@ void drawGame() {
         const char* winnerText = (gameState.leftScore > gameState.rightScore) ? "PLAYER WINS!" : "CPU WINS!";
         const char* restartText = "Press R to Restart";
         
-        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, Fade(BLACK, 0.8f));
+        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, tier->alphaOverlays ? Fade(BLACK, 0.8f) : BLACK);
         DrawText(gameOverText, SCREEN_WIDTH/2 - MeasureText(gameOverText, 40)/2, SCREEN_HEIGHT/2 - 40, 40, WHITE);
         DrawText(winnerText, SCREEN_WIDTH/2 - MeasureText(winnerText, 30)/2, SCREEN_HEIGHT/2, 30, YELLOW);
         DrawText(restartText, SCREEN_WIDTH/2 - MeasureText(restartText, 20)/2, SCREEN_HEIGHT/2 + 40, 20, GREEN);
@@ -406,7 +451,7 @@ void drawGame() {
         const char* pausedText = "GAME PAUSED";
         const char* resumeText = "Press P to Resume";
         
-        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, Fade(BLACK, 0.8f));
+        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, tier->alphaOverlays ? Fade(BLACK, 0.8f) : BLACK);
         DrawText(pausedText, SCREEN_WIDTH/2 - MeasureText(pausedText, 40)/2, SCREEN_HEIGHT/2 - 40, 40, WHITE);
         DrawText(resumeText, SCREEN_WIDTH/2 - MeasureText(resumeText, 20)/2, SCREEN_HEIGHT/2 + 20, 20, GREEN);
     }
@@ -420,37 +465,109 @@ void drawGame() {
     
     pthread_mutex_unlock(&gameState.stateMutex);
     
+    // Telemetry line: active tier, budget and the last measured frame work
+    if (showTelemetry) {
+        char telemetryText[128];
+        snprintf(telemetryText, sizeof(telemetryText), "Quality %s%s  budget %.1f ms  work %.2f ms  %d FPS", tier->name,
+                 quality.fixed ? " (fixed)" : "", quality.budgetMs, quality.workMs, GetFPS());
+        DrawRectangle(0, 0, MeasureText(telemetryText, 20) + 20, 30, BLACK);
+        DrawText(telemetryText, 10, 5, 20, GREEN);
+    }
+    
+    // Work ends before EndDrawing, which waits for the frame rate cap
+    clock_gettime(CLOCK_MONOTONIC, &workEnd);
     EndDrawing();
+    
+    float workMs = (workEnd.tv_sec - workStart.tv_sec) * 1000.0f + (workEnd.tv_nsec - workStart.tv_nsec) / 1e6f;
+    if (pongQualityFrame(&quality, workMs, GetFrameTime() * 1000.0f, true)) {
+        TraceLog(LOG_INFO, "Quality tier: %s, frame work %.2f ms of %.1f ms", pongQualityTier(&quality)->name, quality.workMs, quality.budgetMs);
+    }
+}
+
+// --bench: a seeded CPU vs CPU scene, one tick per frame on this thread (no workers running), so every run draws the same frames
+void runBench(PongBench* bench) {
+    SetRandomSeed(PONG_ATTRACT_SEED);
+    initializeGame();
+    for (long frame = 0; !WindowShouldClose(); frame++) {
+        gameState.level = 1 + (int)(frame / PONG_ATTRACT_LEVEL_FRAMES % 3);  // Every level's effects get their share
+        updateBall();
+        updateAi();
+        updateAttractPaddle();
+        if (gameState.gameOver) {
+            gameState.leftScore = 0;
+            gameState.rightScore = 0;
+            gameState.gameOver = false;
+        }
+        drawGame();
+        if (!pongBenchFrame(bench)) break;
+    }
+    pongBenchReport(bench, "DarkGraphics.c");
 }
 
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+    // --bench [frames]: play the attract scene unthrottled, print frame statistics and quit
+    // --quality low|medium|high|full: pin the effect tier; --frame-budget <ms>: what the governor keeps frames under
+    PongBench bench = {0};
+    int qualityTier = -1;
+    float frameBudgetMs = 1000.0f / 60.0f;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            pongBenchStart(&bench, (i + 1 < argc && argv[i + 1][0] != '-') ? atol(argv[++i]) : PONG_BENCH_FRAMES);
+        }
+        else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            qualityTier = pongQualityParse(argv[++i]);
+            if (qualityTier < 0) printf("Unknown quality %s, the tier follows the frame times\n", argv[i]);
+        }
+        else if (strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc) {
+            frameBudgetMs = atof(argv[++i]);
+            if (!(frameBudgetMs > 0)) frameBudgetMs = 1000.0f / 60.0f;
+        }
+    }
+    
+    // Bench numbers compare the same effects, so the governor stays out of them
+    if (bench.target > 0 && qualityTier < 0) qualityTier = PONG_QUALITY_TIERS - 1;
+    pongQualityInit(&quality, frameBudgetMs, qualityTier);
+    
     // Initialize random seed
     srand(time(NULL));
     
     // Initialize raylib
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "FAST-NU Pong Game - Multithreaded");
-    InitAudioDevice();
-    SetTargetFPS(60);
+    SetTargetFPS(bench.target > 0 ? 0 : 60);
     
-    // Initialize game state
+    // Initialize game state (the mutex only once, R reuses it)
+    pthread_mutex_init(&gameState.stateMutex, NULL);
     initializeGame();
     
+    if (bench.target > 0) {
+        runBench(&bench);
+        pongQualityReport(&quality, "DarkGraphics.c");
+        pthread_mutex_destroy(&gameState.stateMutex);
+        CloseWindow();
+        return 0;
+    }
+    
+    // Load sounds before the threads can play them
+    InitAudioDevice();
+    paddleHitSound = LoadSound("resources/paddle_hit.wav");
+    wallHitSound = LoadSound("resources/wall_hit.wav");
+    scoreSound = LoadSound("resources/score.wav");
+    
     // Create threads
     pthread_t ballThread, aiThread;
     pthread_create(&ballThread, NULL, ballThreadFunc, NULL);
     pthread_create(&aiThread, NULL, aiThreadFunc, NULL);
     
-    // Load sounds
-    Sound paddleHitSound = LoadSound("resources/paddle_hit.wav");
-    Sound wallHitSound = LoadSound("resources/wall_hit.wav");
-    Sound scoreSound = LoadSound("resources/score.wav");
-    
     // Main game loop
     while (!WindowShouldClose()) {
         pthread_mutex_lock(&gameState.stateMutex);
         
         // Process input
+        if (IsKeyPressed(KEY_F3)) {
+            showTelemetry = !showTelemetry;
+        }
+        
         if (IsKeyPressed(KEY_P)) {
             gameState.gamePaused = !gameState.gamePaused;
         }
@@ -495,7 +612,15 @@ int main() {
     }
     
     // Cleanup
+    pongQualityReport(&quality, "DarkGraphics.c");
+    atomic_store(&threadsDone, true);
+    pthread_join(ballThread, NULL);
+    pthread_join(aiThread, NULL);
     pthread_mutex_destroy(&gameState.stateMutex);
+    UnloadSound(paddleHitSound);
+    UnloadSound(wallHitSound);
+    UnloadSound(scoreSound);
+    CloseAudioDevice();
     CloseWindow();
     
     return 0;
@@ -4,7 +4,12 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <raylib.h>
+#include <raymath.h>
 #include <time.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "pong_bench.h"   // --bench frame statistics and draw call counting, after raylib.h
 
 // Game constants
 #define SCREEN_WIDTH 800
@@ -45,186 +50,208 @@ typedef struct {
 // Global game state
 GameState gameState;
 
-// Thread function to update ball movement
-void* ballThreadFunc(void* arg) {
-    while (1) {
-        // Sleep to control update rate
-        usleep(16000); // ~60 updates per second
+// Set on exit so the worker threads return and can be joined
+atomic_bool threadsDone;
+
+// Loaded once in main before the threads start; left empty (silent) with --bench
+Sound paddleHitSound, wallHitSound, scoreSound;
+
+// Advance the ball one tick: walls, paddles and scoring (caller holds stateMutex)
+void updateBall() {
+    if (gameState.gameOver || gameState.gamePaused) {
+        return;
+    }
+    
+    // Update ball position
+    gameState.ballPosition.x += gameState.ballVelocity.x;
+    gameState.ballPosition.y += gameState.ballVelocity.y;
+    
+    // Ball collision with top and bottom walls
+    if (gameState.ballPosition.y <= 0 || gameState.ballPosition.y >= SCREEN_HEIGHT) {
+        gameState.ballVelocity.y *= -1.0f;
+        PlaySound(wallHitSound);
         
-        pthread_mutex_lock(&gameState.stateMutex);
+        // Ensure ball stays within bounds
+        if (gameState.ballPosition.y < 0) gameState.ballPosition.y = 0;
+        if (gameState.ballPosition.y > SCREEN_HEIGHT) gameState.ballPosition.y = SCREEN_HEIGHT;
+    }
+    
+    // Ball collision with paddles
+    if (gameState.ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
+        gameState.ballPosition.y >= gameState.leftPaddleY && 
+        gameState.ballPosition.y <= gameState.leftPaddleY + PADDLE_HEIGHT) {
         
-        if (gameState.gameOver || gameState.gamePaused) {
-            pthread_mutex_unlock(&gameState.stateMutex);
-            continue;
-        }
+        // Calculate reflection angle based on where ball hits paddle
+        float hitPosition = (gameState.ballPosition.y - gameState.leftPaddleY) / PADDLE_HEIGHT;
+        float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
         
-        // Update ball position
-        gameState.ballPosition.x += gameState.ballVelocity.x;
-        gameState.ballPosition.y += gameState.ballVelocity.y;
+        // Increase ball speed slightly with each hit
+        float speed = Vector2Length(gameState.ballVelocity);
+        if (speed < MAX_BALL_SPEED) speed *= 1.05f;
         
-        // Ball collision with top and bottom walls
-        if (gameState.ballPosition.y <= 0 || gameState.ballPosition.y >= SCREEN_HEIGHT) {
-            gameState.ballVelocity.y *= -1.0f;
-            PlaySound(LoadSound("resources/wall_hit.wav"));
-            
-            // Ensure ball stays within bounds
-            if (gameState.ballPosition.y < 0) gameState.ballPosition.y = 0;
-            if (gameState.ballPosition.y > SCREEN_HEIGHT) gameState.ballPosition.y = SCREEN_HEIGHT;
-        }
+        // Set new velocity
+        gameState.ballVelocity.x = speed * cosf(bounceAngle);
+        gameState.ballVelocity.y = speed * sinf(bounceAngle);
         
-        // Ball collision with paddles
-        if (gameState.ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.leftPaddleY && 
-            gameState.ballPosition.y <= gameState.leftPaddleY + PADDLE_HEIGHT) {
-            
-            // Calculate reflection angle based on where ball hits paddle
-            float hitPosition = (gameState.ballPosition.y - gameState.leftPaddleY) / PADDLE_HEIGHT;
-            float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
-            
-            // Increase ball speed slightly with each hit
-            float speed = Vector2Length(gameState.ballVelocity);
-            if (speed < MAX_BALL_SPEED) speed *= 1.05f;
-            
-            // Set new velocity
-            gameState.ballVelocity.x = speed * cosf(bounceAngle);
-            gameState.ballVelocity.y = speed * sinf(bounceAngle);
-            
-            // Ensure ball moves right
-            if (gameState.ballVelocity.x < 0) gameState.ballVelocity.x *= -1;
-            
-            // Move ball outside paddle to prevent multiple collisions
-            gameState.ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;
-            
-            // Play sound
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
-        }
+        // Ensure ball moves right
+        if (gameState.ballVelocity.x < 0) gameState.ballVelocity.x *= -1;
         
-        if (gameState.ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.rightPaddleY && 
-            gameState.ballPosition.y <= gameState.rightPaddleY + PADDLE_HEIGHT) {
-            
-            // Calculate reflection angle based on where ball hits paddle
-            float hitPosition = (gameState.ballPosition.y - gameState.rightPaddleY) / PADDLE_HEIGHT;
-            float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
-            
-            // Increase ball speed slightly with each hit
-            float speed = Vector2Length(gameState.ballVelocity);
-            if (speed < MAX_BALL_SPEED) speed *= 1.05f;
-            
-            // Set new velocity
-            gameState.ballVelocity.x = speed * cosf(bounceAngle);
-            gameState.ballVelocity.y = speed * sinf(bounceAngle);
-            
-            // Ensure ball moves left
-            if (gameState.ballVelocity.x > 0) gameState.ballVelocity.x *= -1;
-            
-            // Move ball outside paddle to prevent multiple collisions
-            gameState.ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
-            
-            // Play sound
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
+        // Move ball outside paddle to prevent multiple collisions
+        gameState.ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;
+        
+        // Play sound
+        PlaySound(paddleHitSound);
+    }
+    
+    if (gameState.ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
+        gameState.ballPosition.y >= gameState.rightPaddleY && 
+        gameState.ballPosition.y <= gameState.rightPaddleY + PADDLE_HEIGHT) {
+        
+        // Calculate reflection angle based on where ball hits paddle
+        float hitPosition = (gameState.ballPosition.y - gameState.rightPaddleY) / PADDLE_HEIGHT;
+        float bounceAngle = (hitPosition - 0.5f) * 1.5f; // -0.75 to 0.75 radians
+        
+        // Increase ball speed slightly with each hit
+        float speed = Vector2Length(gameState.ballVelocity);
+        if (speed < MAX_BALL_SPEED) speed *= 1.05f;
+        
+        // Set new velocity
+        gameState.ballVelocity.x = speed * cosf(bounceAngle);
+        gameState.ballVelocity.y = speed * sinf(bounceAngle);
+        
+        // Ensure ball moves left
+        if (gameState.ballVelocity.x > 0) gameState.ballVelocity.x *= -1;
+        
+        // Move ball outside paddle to prevent multiple collisions
+        gameState.ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
+        
+        // Play sound
+        PlaySound(paddleHitSound);
+    }
+    
+    // Scoring
+    if (gameState.ballPosition.x < 0) {
+        // Right player scores
+        gameState.rightScore++;
+        PlaySound(scoreSound);
+        
+        // Reset ball
+        gameState.ballPosition.x = SCREEN_WIDTH / 2;
+        gameState.ballPosition.y = SCREEN_HEIGHT / 2;
+        gameState.ballVelocity.x = INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
+        gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * (0.6f + ((float)GetRandomValue(0, 40) / 100.0f));
+        
+        // Check for game over
+        if (gameState.rightScore >= MAX_SCORE) {
+            gameState.gameOver = true;
         }
+    }
+    
+    if (gameState.ballPosition.x > SCREEN_WIDTH) {
+        // Left player scores
+        gameState.leftScore++;
+        PlaySound(scoreSound);
         
-        // Scoring
-        if (gameState.ballPosition.x < 0) {
-            // Right player scores
-            gameState.rightScore++;
-            PlaySound(LoadSound("resources/score.wav"));
-            
-            // Reset ball
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            gameState.ballVelocity.x = INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * (0.6f + ((float)GetRandomValue(0, 40) / 100.0f));
-            
-            // Check for game over
-            if (gameState.rightScore >= MAX_SCORE) {
-                gameState.gameOver = true;
-            }
+        // Reset ball
+        gameState.ballPosition.x = SCREEN_WIDTH / 2;
+        gameState.ballPosition.y = SCREEN_HEIGHT / 2;
+        gameState.ballVelocity.x = -INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
+        gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * (0.6f + ((float)GetRandomValue(0, 40) / 100.0f));
+        
+        // Check for game over
+        if (gameState.leftScore >= MAX_SCORE) {
+            gameState.gameOver = true;
         }
+    }
+}
+
+// Thread function to update ball movement
+void* ballThreadFunc(void* arg) {
+    while (!atomic_load(&threadsDone)) {
+        // Sleep to control update rate
+        usleep(16000); // ~60 updates per second
         
-        if (gameState.ballPosition.x > SCREEN_WIDTH) {
-            // Left player scores
-            gameState.leftScore++;
-            PlaySound(LoadSound("resources/score.wav"));
+        pthread_mutex_lock(&gameState.stateMutex);
+        updateBall();
+        pthread_mutex_unlock(&gameState.stateMutex);
+    }
+    
+    return NULL;
+}
+
+// One AI decision for the right paddle (caller holds stateMutex)
+void updateAi() {
+    if (gameState.gameOver || gameState.gamePaused) {
+        return;
+    }
+    
+    // Adjust AI difficulty based on level
+    float difficultyFactor = 0.5f + (gameState.level * 0.1f); // Higher level = better AI
+    
+    // Basic AI: move toward the ball with some prediction and reaction time
+    if (gameState.ballVelocity.x > 0) { // Only move if ball is coming toward AI
+        // Target position is where the ball will be
+        float targetY = gameState.ballPosition.y;
+        
+        // Add prediction capability based on level
+        if (gameState.level > 1) {
+            // Calculate where ball will be when it reaches the paddle
+            float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - gameState.ballPosition.x) / gameState.ballVelocity.x;
+            float predictedY = gameState.ballPosition.y + (gameState.ballVelocity.y * timeToReach);
             
-            // Reset ball
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            gameState.ballVelocity.x = -INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * (0.6f + ((float)GetRandomValue(0, 40) / 100.0f));
+            // Bounce calculation for prediction
+            if (predictedY < 0) predictedY = -predictedY;
+            if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
             
-            // Check for game over
-            if (gameState.leftScore >= MAX_SCORE) {
-                gameState.gameOver = true;
-            }
+            // Adjust target with prediction and AI accuracy
+            targetY = predictedY * difficultyFactor + gameState.ballPosition.y * (1 - difficultyFactor);
         }
         
-        pthread_mutex_unlock(&gameState.stateMutex);
+        // Introduce some error based on difficulty
+        targetY += (GetRandomValue(-100, 100) / 100.0f) * (1.0f - difficultyFactor) * PADDLE_HEIGHT;
+        
+        // Make the paddle move toward the target
+        if (targetY < gameState.rightPaddleY + PADDLE_HEIGHT/2 - 10) {
+            gameState.rightPaddleY -= PADDLE_SPEED * difficultyFactor;
+        } else if (targetY > gameState.rightPaddleY + PADDLE_HEIGHT/2 + 10) {
+            gameState.rightPaddleY += PADDLE_SPEED * difficultyFactor;
+        }
+    } else {
+        // If ball moving away, move toward center with less urgency
+        if (gameState.rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) {
+            gameState.rightPaddleY += PADDLE_SPEED * 0.5f;
+        } else if (gameState.rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) {
+            gameState.rightPaddleY -= PADDLE_SPEED * 0.5f;
+        }
     }
     
-    return NULL;
+    // Ensure paddle stays within screen bounds
+    if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
+    if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
+}
+
+// Attract scene's left CPU (--bench): follows the ball when it comes this way, drifts back to the middle otherwise
+void updateAttractPaddle() {
+    float targetY = gameState.ballVelocity.x < 0 ? gameState.ballPosition.y : SCREEN_HEIGHT / 2;
+    if (targetY < gameState.leftPaddleY + PADDLE_HEIGHT/2 - 10) {
+        gameState.leftPaddleY -= PADDLE_SPEED * 0.8f;
+    } else if (targetY > gameState.leftPaddleY + PADDLE_HEIGHT/2 + 10) {
+        gameState.leftPaddleY += PADDLE_SPEED * 0.8f;
+    }
+    if (gameState.leftPaddleY < 0) gameState.leftPaddleY = 0;
+    if (gameState.leftPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.leftPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
 }
 
 // Thread function for AI (right paddle)
 void* aiThreadFunc(void* arg) {
     float aiReactionTime = 0.05f; // Base reaction time (seconds)
     
-    while (1) {
+    while (!atomic_load(&threadsDone)) {
         // Sleep to control update rate and add some "thinking time"
         usleep(16000); // ~60 updates per second
         
         pthread_mutex_lock(&gameState.stateMutex);
-        
-        if (gameState.gameOver || gameState.gamePaused) {
-            pthread_mutex_unlock(&gameState.stateMutex);
-            continue;
-        }
-        
-        // Adjust AI difficulty based on level
-        float difficultyFactor = 0.5f + (gameState.level * 0.1f); // Higher level = better AI
-        
-        // Basic AI: move toward the ball with some prediction and reaction time
-        if (gameState.ballVelocity.x > 0) { // Only move if ball is coming toward AI
-            // Target position is where the ball will be
-            float targetY = gameState.ballPosition.y;
-            
-            // Add prediction capability based on level
-            if (gameState.level > 1) {
-                // Calculate where ball will be when it reaches the paddle
-                float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - gameState.ballPosition.x) / gameState.ballVelocity.x;
-                float predictedY = gameState.ballPosition.y + (gameState.ballVelocity.y * timeToReach);
-                
-                // Bounce calculation for prediction
-                if (predictedY < 0) predictedY = -predictedY;
-                if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
-                
-                // Adjust target with prediction and AI accuracy
-                targetY = predictedY * difficultyFactor + gameState.ballPosition.y * (1 - difficultyFactor);
-            }
-            
-            // Introduce some error based on difficulty
-            targetY += (GetRandomValue(-100, 100) / 100.0f) * (1.0f - difficultyFactor) * PADDLE_HEIGHT;
-            
-            // Make the paddle move toward the target
-            if (targetY < gameState.rightPaddleY + PADDLE_HEIGHT/2 - 10) {
-                gameState.rightPaddleY -= PADDLE_SPEED * difficultyFactor;
-            } else if (targetY > gameState.rightPaddleY + PADDLE_HEIGHT/2 + 10) {
-                gameState.rightPaddleY += PADDLE_SPEED * difficultyFactor;
-            }
-        } else {
-            // If ball moving away, move toward center with less urgency
-            if (gameState.rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) {
-                gameState.rightPaddleY += PADDLE_SPEED * 0.5f;
-            } else if (gameState.rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) {
-                gameState.rightPaddleY -= PADDLE_SPEED * 0.5f;
-            }
-        }
-        
-        // Ensure paddle stays within screen bounds
-        if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
-        if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
-        
+        updateAi();
         pthread_mutex_unlock(&gameState.stateMutex);
         
         // Sleep based on AI reaction time and difficulty
@@ -253,8 +280,6 @@ void initializeGame() {
     gameState.gamePaused = false;
     
     gameState.level = 1; // Start at level 1
-    
-    pthread_mutex_init(&gameState.stateMutex, NULL);
 }
 
 // Draw game
@@ -350,29 +375,65 @@ void drawGame() {
     EndDrawing();
 }
 
+// --bench: a seeded CPU vs CPU scene, one tick per frame on this thread (no workers running), so every run draws the same frames
+void runBench(PongBench* bench) {
+    SetRandomSeed(PONG_ATTRACT_SEED);
+    initializeGame();
+    for (long frame = 0; !WindowShouldClose(); frame++) {
+        gameState.level = 1 + (int)(frame / PONG_ATTRACT_LEVEL_FRAMES % 3);  // Every level's effects get their share
+        updateBall();
+        updateAi();
+        updateAttractPaddle();
+        if (gameState.gameOver) {
+            gameState.leftScore = 0;
+            gameState.rightScore = 0;
+            gameState.gameOver = false;
+        }
+        drawGame();
+        if (!pongBenchFrame(bench)) break;
+    }
+    pongBenchReport(bench, "LightGraphics.c");
+}
+
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+    // --bench [frames]: play the attract scene unthrottled, print frame statistics and quit
+    PongBench bench = {0};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            pongBenchStart(&bench, (i + 1 < argc && argv[i + 1][0] != '-') ? atol(argv[++i]) : PONG_BENCH_FRAMES);
+        }
+    }
+    
     // Initialize random seed
     srand(time(NULL));
     
     // Initialize raylib
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "FAST-NU Pong Game - Multithreaded");
-    InitAudioDevice();
-    SetTargetFPS(60);
+    SetTargetFPS(bench.target > 0 ? 0 : 60);
     
-    // Initialize game state
+    // Initialize game state (the mutex only once, R reuses it)
+    pthread_mutex_init(&gameState.stateMutex, NULL);
     initializeGame();
     
+    if (bench.target > 0) {
+        runBench(&bench);
+        pthread_mutex_destroy(&gameState.stateMutex);
+        CloseWindow();
+        return 0;
+    }
+    
+    // Load sounds before the threads can play them
+    InitAudioDevice();
+    paddleHitSound = LoadSound("resources/paddle_hit.wav");
+    wallHitSound = LoadSound("resources/wall_hit.wav");
+    scoreSound = LoadSound("resources/score.wav");
+    
     // Create threads
     pthread_t ballThread, aiThread;
     pthread_create(&ballThread, NULL, ballThreadFunc, NULL);
     pthread_create(&aiThread, NULL, aiThreadFunc, NULL);
     
-    // Load sounds
-    Sound paddleHitSound = LoadSound("resources/paddle_hit.wav");
-    Sound wallHitSound = LoadSound("resources/wall_hit.wav");
-    Sound scoreSound = LoadSound("resources/score.wav");
-    
     // Main game loop
     while (!WindowShouldClose()) {
         pthread_mutex_lock(&gameState.stateMutex);
@@ -419,7 +480,14 @@ int main() {
     }
     
     // Cleanup
+    atomic_store(&threadsDone, true);
+    pthread_join(ballThread, NULL);
+    pthread_join(aiThread, NULL);
     pthread_mutex_destroy(&gameState.stateMutex);
+    UnloadSound(paddleHitSound);
+    UnloadSound(wallHitSound);
+    UnloadSound(scoreSound);
+    CloseAudioDevice();
     CloseWindow();
     
     return 0;
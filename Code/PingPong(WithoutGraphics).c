@@ -1,3 +1,4 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -7,10 +8,24 @@
 #include <time.h>
 #include <string.h>
 #include <signal.h>
+#include <math.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <errno.h>
+#include <stddef.h>
+#include "pong_snapshot.h"     // K/L save and load, --resume
+#include "pong_trace.h"        // Zone tracer for --trace, exported as Chrome trace JSON
+#include "pong_rt.h"           // Thread pinning, SCHED_FIFO and tick interval histograms
 #define WIDTH 80
 #define HEIGHT 24
 #define PADDLE_HEIGHT 5
 #define WINNING_SCORE 10
+#define BALL_TICK_US 100000
+#define AI_REACTION_TICKS 1         // The CPU sees the ball as it was this many ball ticks ago
+#define AI_MOVE_MS 150              // and moves its paddle once per this long, on average
+#define AI_HISTORY 8                // Power of two above AI_REACTION_TICKS
+#define CONSOLE_SNAPSHOT_VERSION 1   // Bump with any change to the GameState fields before last_tick
 typedef struct {
     int ball_x;
     int ball_y;
@@ -29,20 +44,75 @@ typedef struct {
     int power_up_x;
     int power_up_y;
     int power_up_timer;
+    int prev_ball_x;     // Position before the last ball tick, for sub-cell interpolation
+    int prev_ball_y;
+    unsigned int rng_seed;     // rand_r state, saved with the snapshot so a resumed game continues the same random sequence
+    struct timespec last_tick;     // Everything above is the snapshot payload
     pthread_mutex_t mutex;     // Mutex for thread synchronization
 } GameState;
 GameState game;
-void initGame() {
-    if (pthread_mutex_init(&game.mutex, NULL) != 0) {
-        printf("Mutex initialization failed\n");
-        exit(1);
-    }
+typedef struct {
+    unsigned char r, g, b;
+} Rgb;
+int halfBlockMode = 0;     // --halfblock: truecolor renderer with two pixels per character cell
+int termCols, termRows;
+Rgb* pixels;               // termCols x (termRows - 2) * 2, top and bottom half of each cell
+char* textOverlay;         // Characters drawn over the pixels (scores, messages), 0 = none
+char* frameBuffer;         // Whole frame, written with a single write()
+size_t frameCapacity;
+PongJitterStats ballJitter = { .binUs = 100 };    // Written by ballThread only; 0.1 ms bins up to 200 ms
+typedef struct {                    // The CPU paddle, a tick function on ballThread instead of a thread sleeping 0.15 s
+    int ballY[AI_HISTORY];          // Ring of the ball's row on each tick
+    long sightings;
+    int owedMs;                     // Ball time not yet turned into moves, one move per AI_MOVE_MS
+} AiPaddle;
+AiPaddle aiPaddle;                  // game.mutex; stepped by ballThread, cleared with the match
+enum { ROLE_BALL, ROLE_INPUT, ROLE_RENDER, ROLE_POWER_UP, ROLE_COUNT };
+const char* roleNames[ROLE_COUNT] = {"ball", "input", "render", "powerup"};
+int roleCpu[ROLE_COUNT] = {-1, -1, -1, -1};     // --pin-<role> <cpu>, -1 = leave to the scheduler
+int realtimePhysics = 0;            // --rt: SCHED_FIFO for the ball thread
+int lockMemory = 0;                 // --mlock
+int jitterReport = 0;               // --jitter-report
+const char* snapshotPath = "pingpong-console.snap";     // K saves, L loads; Q writes it when quitting mid-game
+const char* resumePath = NULL;      // --resume <snapshot>
+const char* tracePath = NULL;       // --trace <file.json>: T writes the zones so far, quitting writes them all
+volatile int quitRequested = 0;     // Q: every thread returns; game_over alone only ends the match
+long restartCount = 0, firstTickCount = 0;     // R rematches, for the restart latency report
+double restartSumUs = 0, restartMaxUs = 0;     // resetMatch() under the lock
+double firstTickSumMs = 0, firstTickMaxMs = 0;     // R to the first ball tick of the new match
+struct timespec restartTime;
+int awaitingFirstTick = 0;          // Guarded by game.mutex
+double microsecondsSince(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e6 + (now.tv_nsec - start->tv_nsec) / 1e3;
+}
+pthread_mutex_t rngMutex = PTHREAD_MUTEX_INITIALIZER;     // Some threads draw numbers without game.mutex
+int nextRandom() {
+    pthread_mutex_lock(&rngMutex);
+    int value = rand_r(&game.rng_seed);
+    pthread_mutex_unlock(&rngMutex);
+    return value;
+}
+PongTraceZone lockGame(const char* holdName) { // game.mutex, with the wait and the hold as zones: a trace shows who stalled whom
+    PongTraceZone wait = pongTraceBegin("wait game.mutex");
+    pthread_mutex_lock(&game.mutex);
+    pongTraceEnd(&wait);
+    return pongTraceBegin(holdName);
+}
+void unlockGame(PongTraceZone* hold) {
+    pthread_mutex_unlock(&game.mutex);
+    pongTraceEnd(hold);
+}
+void resetMatch() { // Match state only; threads and the terminal setup are kept for the rematch
     game.ball_x = WIDTH / 2;
     game.ball_y = HEIGHT / 2;
-    srand(time(NULL));
-    game.ball_dx = (rand() % 2) * 2 - 1;  // -1 or 1
-    game.ball_dy = (rand() % 2) * 2 - 1;  // -1 or 1
+    game.ball_dx = (nextRandom() % 2) * 2 - 1;  // -1 or 1
+    game.ball_dy = (nextRandom() % 2) * 2 - 1;  // -1 or 1
     game.ball_speed = 1;
+    game.prev_ball_x = game.ball_x;
+    game.prev_ball_y = game.ball_y;
+    clock_gettime(CLOCK_MONOTONIC, &game.last_tick);
     game.paddle1_y = HEIGHT / 2 - PADDLE_HEIGHT / 2;     // Set initial paddle positions
     game.paddle2_y = HEIGHT / 2 - PADDLE_HEIGHT / 2;
     game.paddle_speed = 1;    
@@ -53,29 +123,41 @@ void initGame() {
     game.power_up_active = 0;     // Initialize power-up
     game.power_up_type = 0;
     game.power_up_timer = 0;
+    memset(&aiPaddle, 0, sizeof(aiPaddle));     // No sightings or owed time carried over from the last match
+}
+void initGame() {
+    if (pthread_mutex_init(&game.mutex, NULL) != 0) {
+        printf("Mutex initialization failed\n");
+        exit(1);
+    }
+    game.rng_seed = time(NULL);
+    resetMatch();
 }
 void resetBall() {
-    pthread_mutex_lock(&game.mutex);
+    PongTraceZone hold = lockGame("reset ball (holds game.mutex)");
     game.ball_x = WIDTH / 2;     // Reset to center
     game.ball_y = HEIGHT / 2;
-    game.ball_dx = (rand() % 2) * 2 - 1;  // -1 or 1
-    game.ball_dy = (rand() % 2) * 2 - 1;  // -1 or 1
+    game.ball_dx = (nextRandom() % 2) * 2 - 1;  // -1 or 1
+    game.ball_dy = (nextRandom() % 2) * 2 - 1;  // -1 or 1
     game.ball_speed = 1;
-    pthread_mutex_unlock(&game.mutex);
+    game.prev_ball_x = game.ball_x;
+    game.prev_ball_y = game.ball_y;
+    unlockGame(&hold);
+    PONG_ZONE("serve pause");
     usleep(500000);
 }
 void spawnPowerUp() {
-    if (!game.power_up_active && rand() % 100 < 5) {  // 5% chance each update
-        pthread_mutex_lock(&game.mutex);
+    if (!game.power_up_active && nextRandom() % 100 < 5) {  // 5% chance each update
+        PongTraceZone hold = lockGame("spawn power-up (holds game.mutex)");
         game.power_up_active = 1;
-        game.power_up_type = rand() % 3;  // 0: faster ball, 1: larger paddle, 2: slower opponent
-        game.power_up_x = WIDTH / 4 + rand() % (WIDTH / 2);  
-        game.power_up_y = 2 + rand() % (HEIGHT - 4);        
-        pthread_mutex_unlock(&game.mutex);
+        game.power_up_type = nextRandom() % 3;  // 0: faster ball, 1: larger paddle, 2: slower opponent
+        game.power_up_x = WIDTH / 4 + nextRandom() % (WIDTH / 2);  
+        game.power_up_y = 2 + nextRandom() % (HEIGHT - 4);        
+        unlockGame(&hold);
     }
 }
 void applyPowerUp(int player) {
-    pthread_mutex_lock(&game.mutex);
+    PongTraceZone hold = lockGame("apply power-up (holds game.mutex)");
     switch (game.power_up_type) {
         case 0:  // Faster ball
             game.ball_speed = 2;
@@ -97,15 +179,60 @@ void applyPowerUp(int player) {
     }
     game.power_up_active = 0;
     game.power_up_timer = 100;  // Effect lasts for 100 updates
-    pthread_mutex_unlock(&game.mutex);
+    unlockGame(&hold);
+}
+void stepAiPaddle() { // ballThread, game.mutex held, before the ball moves: same play however busy the machine is
+    PONG_ZONE("cpu prediction");
+    aiPaddle.ballY[aiPaddle.sightings++ % AI_HISTORY] = game.ball_y;
+    aiPaddle.owedMs += BALL_TICK_US / 1000;
+    if (aiPaddle.owedMs < AI_MOVE_MS) return;
+    aiPaddle.owedMs -= AI_MOVE_MS;
+    long delay = aiPaddle.sightings - 1 < AI_REACTION_TICKS ? aiPaddle.sightings - 1 : AI_REACTION_TICKS;
+    int target_y = aiPaddle.ballY[(aiPaddle.sightings - 1 - delay) % AI_HISTORY] - PADDLE_HEIGHT / 2;
+    if (nextRandom() % 10 < 2) {  // 20% chance of moving randomly
+        target_y += (nextRandom() % 5) - 2;
+    }
+    if (game.paddle2_y < target_y) {
+        game.paddle2_y += game.paddle_speed;
+    } else if (game.paddle2_y > target_y) {
+        game.paddle2_y -= game.paddle_speed;
+    }
+    if (game.paddle2_y < 0) {
+        game.paddle2_y = 0;
+    } else if (game.paddle2_y > HEIGHT - PADDLE_HEIGHT) {
+        game.paddle2_y = HEIGHT - PADDLE_HEIGHT;
+    }
 }
 void* ballThread(void* arg) {
-    while (!game.game_over) {
-        if (game.pause) {
-            usleep(100000);
+    pongTraceThread("Ball");
+    struct timespec lastTick, now;
+    int firstTick = 1;
+    while (!quitRequested) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (!firstTick) {     // Interval covers the previous iteration's sleep and work, only ever a full tick
+            pongRecordTickInterval(&ballJitter, (now.tv_sec - lastTick.tv_sec) * 1e6 + (now.tv_nsec - lastTick.tv_nsec) / 1e3);
+        }
+        lastTick = now;
+        firstTick = 0;
+        if (game.pause || game.game_over) {
+            usleep(game.game_over ? 10000 : 100000);     // Short while over, so a rematch starts within a frame
+            firstTick = 1;     // A poll, not a tick: the next pass starts a fresh interval
             continue;
         }
-        pthread_mutex_lock(&game.mutex);
+        PongTraceZone hold = lockGame("tick (holds game.mutex)");
+        if (awaitingFirstTick) {
+            double latencyMs = (now.tv_sec - restartTime.tv_sec) * 1000.0 + (now.tv_nsec - restartTime.tv_nsec) / 1e6;
+            firstTickSumMs += latencyMs;
+            if (latencyMs > firstTickMaxMs) firstTickMaxMs = latencyMs;
+            firstTickCount++;
+            awaitingFirstTick = 0;
+        }
+        stepAiPaddle();
+        game.prev_ball_x = game.ball_x;
+        game.prev_ball_y = game.ball_y;
+        clock_gettime(CLOCK_MONOTONIC, &game.last_tick);
+        PongTraceZone collision = pongTraceBegin("collision and scoring");
+        int scorer = 0;
         for (int i = 0; i < game.ball_speed; i++) {
             game.ball_x += game.ball_dx;
             game.ball_y += game.ball_dy;
@@ -116,16 +243,16 @@ void* ballThread(void* arg) {
                 game.ball_y >= game.paddle1_y && 
                 game.ball_y < game.paddle1_y + PADDLE_HEIGHT) {
                 game.ball_dx = -game.ball_dx;
-                if (rand() % 3 == 0) {                 // Add some randomness to bounce
-                    game.ball_dy = (rand() % 2) * 2 - 1;
+                if (nextRandom() % 3 == 0) {                 // Add some randomness to bounce
+                    game.ball_dy = (nextRandom() % 2) * 2 - 1;
                 }
             }
             if (game.ball_x == WIDTH - 2 && 
                 game.ball_y >= game.paddle2_y && 
                 game.ball_y < game.paddle2_y + PADDLE_HEIGHT) {
                 game.ball_dx = -game.ball_dx;
-                if (rand() % 3 == 0) {
-                    game.ball_dy = (rand() % 2) * 2 - 1;
+                if (nextRandom() % 3 == 0) {
+                    game.ball_dy = (nextRandom() % 2) * 2 - 1;
                 }
             }
             if (game.power_up_active && 
@@ -136,25 +263,25 @@ void* ballThread(void* arg) {
             }
             if (game.ball_x <= 0) {
                 game.score2++;
-                pthread_mutex_unlock(&game.mutex);
-                resetBall();
-                pthread_mutex_lock(&game.mutex);
-                if (game.score2 >= WINNING_SCORE) {
-                    game.game_over = 1;
-                }
+                scorer = 2;
                 break;
             }
             if (game.ball_x >= WIDTH - 1) {
                 game.score1++;
-                pthread_mutex_unlock(&game.mutex);
-                resetBall();
-                pthread_mutex_lock(&game.mutex);
-                if (game.score1 >= WINNING_SCORE) {
-                    game.game_over = 1;
-                }
+                scorer = 1;
                 break;
             }
         }
+        pongTraceEnd(&collision);
+        if (scorer) {                // The serve pause runs without the lock, so input and rendering carry on
+            unlockGame(&hold);
+            resetBall();
+            firstTick = 1;     // The serve pause is game state, not scheduling delay
+            hold = lockGame("tick (holds game.mutex)");
+            if ((scorer == 1 ? game.score1 : game.score2) >= WINNING_SCORE) {
+                game.game_over = 1;
+            }
+        }
         if (game.power_up_timer > 0) {
             game.power_up_timer--;
             if (game.power_up_timer == 0) {
@@ -162,40 +289,15 @@ void* ballThread(void* arg) {
                 game.paddle_speed = 1;
             }
         }
-        pthread_mutex_unlock(&game.mutex);
-        usleep(100000);  // 0.1 seconds
+        unlockGame(&hold);
+        usleep(BALL_TICK_US);  // 0.1 seconds
     }
     return NULL;
 }
-void* aiPaddleThread(void* arg) {
-    while (!game.game_over) {
-        if (game.pause) {
-            usleep(100000);
-            continue;
-        }
-        pthread_mutex_lock(&game.mutex);
-        int target_y = game.ball_y - PADDLE_HEIGHT / 2;
-        if (rand() % 10 < 2) {  // 20% chance of moving randomly
-            target_y += (rand() % 5) - 2;
-        }
-        if (game.paddle2_y < target_y) {
-            game.paddle2_y += game.paddle_speed;
-        } else if (game.paddle2_y > target_y) {
-            game.paddle2_y -= game.paddle_speed;
-        }
-        if (game.paddle2_y < 0) {
-            game.paddle2_y = 0;
-        } else if (game.paddle2_y > HEIGHT - PADDLE_HEIGHT) {
-            game.paddle2_y = HEIGHT - PADDLE_HEIGHT;
-        }
-        pthread_mutex_unlock(&game.mutex);
-        usleep(150000);  // 0.15 seconds (AI reaction time)
-    } 
-    return NULL;
-}
 void* powerUpThread(void* arg) {
-    while (!game.game_over) {
-        if (game.pause) {
+    pongTraceThread("PowerUp");
+    while (!quitRequested) {
+        if (game.pause || game.game_over) {
             usleep(100000);
             continue;
         }
@@ -218,12 +320,30 @@ void disableRawMode() {
     tcsetattr(STDIN_FILENO, TCSANOW, &term);
     fcntl(STDIN_FILENO, F_SETFL, 0);
 }
+void copySnapshot(GameState* copy) { // With game.mutex held: the saved fields, so the file is written without the lock
+    pthread_mutex_lock(&rngMutex);
+    memcpy(copy, &game, offsetof(GameState, last_tick));
+    pthread_mutex_unlock(&rngMutex);
+}
+int loadSnapshot(const char* path) { // With game.mutex held
+    GameState loaded;
+    if (!pongSnapshotLoad(path, PONG_SNAPSHOT_CONSOLE, CONSOLE_SNAPSHOT_VERSION, &loaded, offsetof(GameState, last_tick), 0)) return 0;
+    pthread_mutex_lock(&rngMutex);
+    memcpy(&game, &loaded, offsetof(GameState, last_tick));
+    pthread_mutex_unlock(&rngMutex);
+    memset(&aiPaddle, 0, sizeof(aiPaddle));     // The ball it saw before the load is not where the snapshot put it
+    clock_gettime(CLOCK_MONOTONIC, &game.last_tick);
+    return 1;
+}
 void* inputThread(void* arg) {
     char c;
+    pongTraceThread("Input");
     enableRawMode();
-    while (!game.game_over) {
+    while (!quitRequested) {
         if (read(STDIN_FILENO, &c, 1) == 1) {
-            pthread_mutex_lock(&game.mutex);
+            int writeTrace = 0, saveOnQuit = 0;
+            GameState quitSnapshot;
+            PongTraceZone hold = lockGame("key (holds game.mutex)");
             switch (c) {
                 case 'w':
                 case 'W':
@@ -244,19 +364,209 @@ void* inputThread(void* arg) {
                 case 'P':
                     game.pause = !game.pause;
                     break;
+                case 'k':
+                case 'K': {
+                    GameState copy;
+                    copySnapshot(&copy);
+                    if (!pongSnapshotSaveAsync(snapshotPath, PONG_SNAPSHOT_CONSOLE, CONSOLE_SNAPSHOT_VERSION, &copy, offsetof(GameState, last_tick))) {
+                        printf("Could not start saving %s\n", snapshotPath);
+                    }
+                    break;
+                }
+                case 'l':
+                case 'L':
+                    loadSnapshot(snapshotPath);
+                    break;
+                case 'r':
+                case 'R':
+                    if (game.game_over) {
+                        clock_gettime(CLOCK_MONOTONIC, &restartTime);
+                        resetMatch();
+                        double resetUs = microsecondsSince(&restartTime);
+                        restartCount++;
+                        restartSumUs += resetUs;
+                        if (resetUs > restartMaxUs) restartMaxUs = resetUs;
+                        awaitingFirstTick = 1;
+                    }
+                    break;
+                case 't':
+                case 'T':
+                    writeTrace = tracePath != NULL;
+                    break;
                 case 'q':
                 case 'Q':
+                    if (!game.game_over) {     // Quitting mid-game: --resume picks it up
+                        copySnapshot(&quitSnapshot);
+                        saveOnQuit = 1;
+                    }
                     game.game_over = 1;
+                    quitRequested = 1;
                     break;
             }
-            pthread_mutex_unlock(&game.mutex);
+            unlockGame(&hold);
+            if (saveOnQuit) {     // Synchronous, so the file is complete before the process exits
+                pongSnapshotSave(snapshotPath, PONG_SNAPSHOT_CONSOLE, CONSOLE_SNAPSHOT_VERSION, &quitSnapshot, offsetof(GameState, last_tick));
+            }
+            if (writeTrace) pongTraceWrite(tracePath);     // Outside the lock: the other threads keep tracing
         }
         usleep(10000);  // 0.01 seconds
     }
     disableRawMode();
     return NULL;
 }
+void queryTerminalSize() { // Grows the buffers when the terminal does, they are never shrunk
+    struct winsize ws;
+    int cols = WIDTH, rows = HEIGHT + 2;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 3) {
+        cols = ws.ws_col;
+        rows = ws.ws_row;
+    }
+    size_t needed = (size_t)cols * rows * 48 + 64;  // Worst case: both colors change on every cell
+    if (needed > frameCapacity) {
+        free(pixels);
+        free(textOverlay);
+        free(frameBuffer);
+        pixels = malloc((size_t)cols * rows * 2 * sizeof(Rgb));
+        textOverlay = malloc((size_t)cols * rows);
+        frameBuffer = malloc(needed);
+        if (!pixels || !textOverlay || !frameBuffer) {
+            printf("Out of memory for the half-block renderer\n");
+            exit(1);
+        }
+        frameCapacity = needed;
+    }
+    termCols = cols;
+    termRows = rows;
+}
+void fillCells(int x, int y, int w, int h, Rgb color) { // Game grid cells to pixels
+    int fieldHeight = (termRows - 2) * 2;
+    int x0 = x * termCols / WIDTH, x1 = (x + w) * termCols / WIDTH;
+    int y0 = y * fieldHeight / HEIGHT, y1 = (y + h) * fieldHeight / HEIGHT;
+    for (int py = y0; py < y1 && py < fieldHeight; py++) {
+        for (int px = x0; px < x1 && px < termCols; px++) {
+            if (px >= 0 && py >= 0) pixels[py * termCols + px] = color;
+        }
+    }
+}
+void drawBallPixels(float ballX, float ballY, Rgb color) { // Anti-aliased disc one cell across, at a float grid position
+    int fieldHeight = (termRows - 2) * 2;
+    float sx = (float)termCols / WIDTH, sy = (float)fieldHeight / HEIGHT;
+    float cx = (ballX + 0.5f) * sx, cy = (ballY + 0.5f) * sy;
+    float rx = 0.5f * sx, ry = 0.5f * sy;
+    float edge = fminf(rx, ry);
+    for (int py = (int)(cy - ry) - 1; py <= (int)(cy + ry) + 1; py++) {
+        for (int px = (int)(cx - rx) - 1; px <= (int)(cx + rx) + 1; px++) {
+            if (px < 0 || px >= termCols || py < 0 || py >= fieldHeight) continue;
+            float dx = (px + 0.5f - cx) / rx, dy = (py + 0.5f - cy) / ry;
+            float coverage = (1.0f - sqrtf(dx * dx + dy * dy)) * edge + 0.5f;
+            if (coverage <= 0.0f) continue;
+            if (coverage > 1.0f) coverage = 1.0f;
+            Rgb* p = &pixels[py * termCols + px];
+            p->r += (color.r - p->r) * coverage;
+            p->g += (color.g - p->g) * coverage;
+            p->b += (color.b - p->b) * coverage;
+        }
+    }
+}
+void putText(int row, int col, const char* text) {
+    for (int i = 0; text[i] && col + i < termCols; i++) {
+        if (col + i >= 0 && row >= 0 && row < termRows) textOverlay[row * termCols + col + i] = text[i];
+    }
+}
+char* appendNumber(char* out, int value) {
+    if (value >= 100) *out++ = '0' + value / 100;
+    if (value >= 10) *out++ = '0' + value / 10 % 10;
+    *out++ = '0' + value % 10;
+    return out;
+}
+char* appendColor(char* out, int layer, Rgb c) { // layer 38 = foreground, 48 = background
+    *out++ = '\033'; *out++ = '[';
+    out = appendNumber(out, layer);
+    *out++ = ';'; *out++ = '2'; *out++ = ';';
+    out = appendNumber(out, c.r); *out++ = ';';
+    out = appendNumber(out, c.g); *out++ = ';';
+    out = appendNumber(out, c.b); *out++ = 'm';
+    return out;
+}
+void renderGameHalfBlock() {
+    const Rgb background = {20, 20, 50}, wall = {120, 120, 140}, centerLine = {70, 70, 110};
+    const Rgb paddleColor = {240, 240, 240}, ballColor = {255, 230, 120};
+    const Rgb powerUpColors[] = {{255, 90, 90}, {90, 200, 255}, {180, 120, 255}};  // Speed, Large, Debuff
+    queryTerminalSize();
+    int fieldHeight = (termRows - 2) * 2;
+    for (int i = 0; i < termCols * fieldHeight; i++) pixels[i] = background;
+    memset(textOverlay, 0, (size_t)termCols * termRows);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    PongTraceZone hold = lockGame("draw (holds game.mutex)");
+    fillCells(0, 0, WIDTH, 1, wall);
+    fillCells(0, HEIGHT - 1, WIDTH, 1, wall);
+    for (int y = 1; y < HEIGHT - 1; y += 2) {
+        fillCells(WIDTH / 2, y, 1, 1, centerLine);
+    }
+    fillCells(1, game.paddle1_y, 1, PADDLE_HEIGHT, paddleColor);
+    fillCells(WIDTH - 2, game.paddle2_y, 1, PADDLE_HEIGHT, paddleColor);
+    if (game.power_up_active) {
+        fillCells(game.power_up_x, game.power_up_y, 1, 1, powerUpColors[game.power_up_type]);
+    }
+    float t = ((now.tv_sec - game.last_tick.tv_sec) * 1e6f + (now.tv_nsec - game.last_tick.tv_nsec) / 1e3f) / BALL_TICK_US;
+    if (t > 1.0f || game.pause) t = 1.0f;
+    drawBallPixels(game.prev_ball_x + (game.ball_x - game.prev_ball_x) * t,
+                   game.prev_ball_y + (game.ball_y - game.prev_ball_y) * t, ballColor);
+    char text[64];
+    sprintf(text, "Player: %d   AI: %d", game.score1, game.score2);
+    putText(0, (termCols - (int)strlen(text)) / 2, text);
+    const char* message = NULL;
+    if (game.game_over) {
+        message = (game.score1 >= WINNING_SCORE) ? "GAME OVER - YOU WIN! R - Rematch" : "GAME OVER - AI WINS! R - Rematch";
+    } else if (game.pause) {
+        message = "GAME PAUSED - Press P to resume";
+    }
+    unlockGame(&hold);
+    if (message) putText((termRows - 2) / 2, (termCols - (int)strlen(message)) / 2, message);
+    putText(termRows - 2, 0, "Controls: W - Move Up, S - Move Down, P - Pause, K - Save, L - Load, Q - Quit");
+    putText(termRows - 1, 0, "Power-ups: S - Speed Boost, L - Larger Paddle, D - Slow Opponent");
+    char* out = frameBuffer;
+    out += sprintf(out, "\033[H");     // Home and overdraw, no clear, so there is no flicker
+    Rgb fg = {0, 0, 0}, bg = {0, 0, 0};
+    int colorsValid = 0;
+    for (int row = 0; row < termRows; row++) {
+        for (int col = 0; col < termCols; col++) {
+            char overlay = textOverlay[row * termCols + col];
+            Rgb top = background, bottom = background;
+            if (row < termRows - 2) {
+                top = pixels[(row * 2) * termCols + col];
+                bottom = pixels[(row * 2 + 1) * termCols + col];
+            } else {
+                top = bottom = (Rgb){0, 0, 0};
+            }
+            Rgb wantFg = overlay ? (Rgb){255, 255, 255} : top;
+            Rgb wantBg = overlay ? top : bottom;
+            if (!colorsValid || memcmp(&wantFg, &fg, sizeof(Rgb)) != 0) out = appendColor(out, 38, fg = wantFg);  // Only on change
+            if (!colorsValid || memcmp(&wantBg, &bg, sizeof(Rgb)) != 0) out = appendColor(out, 48, bg = wantBg);
+            colorsValid = 1;
+            if (overlay) {
+                *out++ = overlay;
+            } else {
+                memcpy(out, "\xe2\x96\x80", 3);     // U+2580 upper half block
+                out += 3;
+            }
+        }
+    }
+    out += sprintf(out, "\033[0m");
+    PONG_ZONE("write terminal");
+    for (char* p = frameBuffer; p < out;) {
+        ssize_t written = write(STDOUT_FILENO, p, out - p);
+        if (written <= 0) break;
+        p += written;
+    }
+}
 void renderGame() {
+    PONG_ZONE("renderGame");
+    if (halfBlockMode) {
+        renderGameHalfBlock();
+        return;
+    }
     printf("\033[2J\033[H"); // Clear screen (ANSI escape code)
     char display[HEIGHT][WIDTH + 1];
     for (int y = 0; y < HEIGHT; y++) {
@@ -265,7 +575,7 @@ void renderGame() {
         }
         display[y][WIDTH] = '\0';
     }
-    pthread_mutex_lock(&game.mutex);
+    PongTraceZone hold = lockGame("draw (holds game.mutex)");
     for (int x = 0; x < WIDTH; x++) {
         display[0][x] = '=';
         display[HEIGHT - 1][x] = '=';
@@ -310,9 +620,9 @@ void renderGame() {
     if (game.game_over) {
         const char* game_over_msg;
         if (game.score1 >= WINNING_SCORE) {
-            game_over_msg = "GAME OVER - YOU WIN!";
+            game_over_msg = "GAME OVER - YOU WIN! R - Rematch";
         } else {
-            game_over_msg = "GAME OVER - AI WINS!";
+            game_over_msg = "GAME OVER - AI WINS! R - Rematch";
         }
         int msg_len = strlen(game_over_msg);
         int start_x = (WIDTH - msg_len) / 2;
@@ -320,47 +630,72 @@ void renderGame() {
             display[HEIGHT / 2][start_x + i] = game_over_msg[i];
         }
     }
-    pthread_mutex_unlock(&game.mutex);
+    unlockGame(&hold);
+    PONG_ZONE("write terminal");
     for (int y = 0; y < HEIGHT; y++) {
         printf("%s\n", display[y]);
     }
-    printf("\nControls: W - Move Up, S - Move Down, P - Pause, Q - Quit\n");
+    printf("\nControls: W - Move Up, S - Move Down, P - Pause, K - Save, L - Load, Q - Quit\n");
     printf("Power-ups: S - Speed Boost, L - Larger Paddle, D - Slow Opponent\n");
 }
 void* renderThread(void* arg) {
-    while (!game.game_over) {
+    pongTraceThread("Render");
+    while (!quitRequested) {
         renderGame();
-        usleep(50000);  // Render at 20 FPS
+        usleep(halfBlockMode ? 16000 : 50000);  // Render at 20 FPS, 60 FPS in half-block mode
     }
     renderGame();     // Final render after game over
     return NULL;
 }
 void handleSignal(int signum) {
     disableRawMode();
+    if (halfBlockMode) printf("\033[0m\033[?25h\033[2J\033[H");
     printf("\nGame terminated by signal %d\n", signum);
     exit(0);
 }
-int main() {
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--halfblock") == 0) halfBlockMode = 1;
+        else if (strcmp(argv[i], "--rt") == 0) realtimePhysics = 1;
+        else if (strcmp(argv[i], "--mlock") == 0) lockMemory = 1;
+        else if (strcmp(argv[i], "--jitter-report") == 0) jitterReport = 1;
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshotPath = argv[++i];
+        else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) resumePath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (strncmp(argv[i], "--pin-", 6) == 0 && i + 1 < argc) {
+            for (int role = 0; role < ROLE_COUNT; role++) {
+                if (strcmp(argv[i] + 6, roleNames[role]) == 0) roleCpu[role] = atoi(argv[i + 1]);
+            }
+            i++;
+        }
+    }
+    if (lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        printf("Could not lock memory: %s\n", strerror(errno));
+    }
+    pongTraceOn = tracePath != NULL;     // Before any thread starts: they only read it
     signal(SIGINT, handleSignal); // Set up signal handler
     printf("=== Zain Allaudin_PING PONG ===\n");
-    printf("Controls: W - Move Up, S - Move Down, P - Pause, Q - Quit\n");
+    printf("Controls: W - Move Up, S - Move Down, P - Pause, K - Save, L - Load, Q - Quit\n");
     printf("First to score %d points wins!\n", WINNING_SCORE);
     printf("Special power-ups will appear during the game!\n");
     printf("Press Enter to start...");
     getchar();
     initGame();
-    pthread_t ball_thread, ai_thread, input_thread, render_thread, power_up_thread;
+    if (resumePath && !loadSnapshot(resumePath)) {
+        printf("Cannot resume from %s: missing or from another version\n", resumePath);
+        return 1;
+    }
+    if (halfBlockMode) {
+        printf("\033[?25l\033[2J");     // Hide cursor
+        fflush(stdout);     // Frames bypass stdio
+    }
+    pthread_t ball_thread, input_thread, render_thread, power_up_thread;
     int ret;
     ret = pthread_create(&ball_thread, NULL, ballThread, NULL);
     if (ret != 0) {
         printf("Error creating ball thread: %d\n", ret);
         return 1;
     }
-    ret = pthread_create(&ai_thread, NULL, aiPaddleThread, NULL);
-    if (ret != 0) {
-        printf("Error creating AI thread: %d\n", ret);
-        return 1;
-    }
     ret = pthread_create(&input_thread, NULL, inputThread, NULL);
     if (ret != 0) {
         printf("Error creating input thread: %d\n", ret);
@@ -376,13 +711,23 @@ int main() {
         printf("Error creating power-up thread: %d\n", ret);
         return 1;
     }
+    pongConfigureThread(ball_thread, roleNames[ROLE_BALL], roleCpu[ROLE_BALL], realtimePhysics);
+    pongConfigureThread(input_thread, roleNames[ROLE_INPUT], roleCpu[ROLE_INPUT], 0);
+    pongConfigureThread(render_thread, roleNames[ROLE_RENDER], roleCpu[ROLE_RENDER], 0);
+    pongConfigureThread(power_up_thread, roleNames[ROLE_POWER_UP], roleCpu[ROLE_POWER_UP], 0);
     pthread_join(ball_thread, NULL);
-    pthread_join(ai_thread, NULL);
     pthread_join(input_thread, NULL);
     pthread_join(render_thread, NULL);
     pthread_join(power_up_thread, NULL);
     pthread_mutex_destroy(&game.mutex);
+    if (halfBlockMode) printf("\033[?25h\033[2J\033[H");
     printf("\nGame Over! Final Score: Player %d - AI %d\n", game.score1, game.score2);
+    if (jitterReport) pongPrintJitterReport(&ballJitter, "Ball thread", BALL_TICK_US);
+    if (firstTickCount > 0) {
+        printf("Rematches: %ld, reset avg %.1f us max %.1f us, first tick after avg %.1f ms max %.1f ms\n", restartCount,
+               restartSumUs / restartCount, restartMaxUs, firstTickSumMs / firstTickCount, firstTickMaxMs);
+    }
+    if (tracePath) pongTraceWrite(tracePath);
     printf("Thanks for playing!\n");
     return 0;
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np
 #include <stdio.h> // To run this game 1st build bash by writing bash build.bash in terminal
 #include <stdlib.h>
 #include <stdbool.h>
@@ -5,306 +6,958 @@
 #include <unistd.h>
 #include <raylib.h>
 #include <time.h> 
-#define SCREEN_WIDTH 1280
-#define SCREEN_HEIGHT 800
-#define PADDLE_WIDTH 20
-#define PADDLE_HEIGHT 100
-#define BALL_RADIUS 10
-#define PADDLE_SPEED 7.0f
-#define INITIAL_BALL_SPEED 7.5f      
-#define MAX_BALL_SPEED 15.0f         
-#define MAX_SCORE 10
-typedef struct {
-    float leftPaddleY;
-    float rightPaddleY;
-    Vector2 ballPosition;
-    Vector2 ballVelocity;
-    int leftScore;
-    int rightScore;
-    bool gameOver;
-    bool gamePaused;
-    int level;
-    bool twoPlayerMode;     
-    bool modeSelected;      
-    pthread_mutex_t stateMutex;     // Synchronization
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdalign.h>
+#include <sched.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "pong_sim.h"     // Screen/paddle/ball constants, ball physics and CPU paddle logic
+#include "pong_levels.h"  // Level table and palettes, built in or from --levels
+#include "pong_video.h"   // Y4M/RLE clip writers for --record
+#include "pong_rally.h"   // Rally event records and their columnar file for --analytics
+#include "pong_leaderboard.h"     // Match history log and top wins
+#include "pong_shm.h"     // Seqlocked live state in shared memory for --export-state
+#include "pong_bot.h"     // External paddle controllers over Unix sockets for --bot-left/--bot-right
+#include "pong_snapshot.h"     // Binary match snapshots for F5/F8, --resume and the .states log
+#include "pong_bench.h"   // --bench frame statistics and draw call counting, after raylib.h
+#include "pong_evdev.h"   // Paddle keys from /dev/input with kernel timestamps for --evdev
+#include "pong_trace.h"   // Zone tracer for --trace, exported as Chrome trace JSON
+#include "pong_quality.h" // Effect tiers picked from recent frame times
+#include "pong_rt.h"      // Thread pinning, SCHED_FIFO and tick interval histograms
+#define MIN_RENDER_SCALE 0.25f
+#define RENDER_SCALE_STEP 0.125f
+#define AUDIO_SAMPLE_RATE 48000
+#define SOUND_EVENT_CAPACITY 64     // Power of two, SPSC ring between ballThreadFunc and the audio callback
+#define MAX_VOICES 8
+#define BALL_TICK_US 16000
+#define RECORD_WIDTH 640            // Clips are recorded at half the scene size
+#define RECORD_HEIGHT 400
+#define RECORD_RING_SLOTS 8         // Frames queued for the encoder thread before new ones are dropped
+#define RALLY_RING_CAPACITY 4096    // Power of two, SPSC ring between ballThreadFunc and the analytics flusher
+#define RALLY_FLUSH_MS 1000         // A partial block is written after this long
+#define INPUT_COMMAND_CAPACITY 64   // Power of two, SPSC ring of key changes from the main loop to ballThreadFunc
+#define PADDLE_SPEED_PER_SECOND (PADDLE_SPEED * 60.0f)     // Keyboard paddles: PADDLE_SPEED per frame at the old 60 FPS
+#define INPUT_LATENCY_SAMPLES 8192  // --input-latency keeps this many presses for its percentiles
+#define RESULT_RING_CAPACITY 16     // Power of two, SPSC ring of finished matches from the main loop to the leaderboard thread
+#define LEADERBOARD_SNAPSHOT_EVERY 256     // Appends between index snapshots
+#define LEADERBOARD_SHOWN 5         // Best wins listed on the mode selection screen
+typedef struct {                    // Split by writer, one cache line each, so the tick path takes no lock
+    alignas(64) PongMatch match;    // Paddles, ball, scores, level and RNG: written and read by ballThreadFunc only
+    alignas(64) atomic_bool gamePaused;     // Written by the main thread only
+    atomic_bool twoPlayerMode;
+    atomic_bool modeSelected;
+    alignas(64) atomic_uint publishedSequence;     // Seqlock: odd while ballThreadFunc copies into published
+    PongMatchSnapshot published;    // match as of the last tick, for every other thread
+    unsigned int publishedCommands; // inputCommands.tail when it was published: the main loop's commands up to here are in it
 } GameState;
 GameState gameState;
-void* ballThreadFunc(void* arg) {
-    while (1) {
-        // Sleep to control update rate
-        usleep(16000); // ~60 updates per second
-        pthread_mutex_lock(&gameState.stateMutex);
-        if (gameState.gameOver || gameState.gamePaused || !gameState.modeSelected) {         // Skip if game is paused, over, or mode not selected
-            pthread_mutex_unlock(&gameState.stateMutex);
-            continue;
-        }
-        gameState.ballPosition.x += gameState.ballVelocity.x;         // Update ball position
-        gameState.ballPosition.y += gameState.ballVelocity.y;
-        if (gameState.ballPosition.y <= 0 || gameState.ballPosition.y >= SCREEN_HEIGHT) {         // Ball collision with top and bottom walls
-            gameState.ballVelocity.y *= -1.0f;
-            PlaySound(LoadSound("resources/wall_hit.wav"));
-            if (gameState.ballPosition.y < 0) gameState.ballPosition.y = 0;             // Ensure ball stays within bounds
-            if (gameState.ballPosition.y > SCREEN_HEIGHT) gameState.ballPosition.y = SCREEN_HEIGHT;
-        }
-        if (gameState.ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.leftPaddleY && 
-            gameState.ballPosition.y <= gameState.leftPaddleY + PADDLE_HEIGHT) {
-            float hitPosition = (gameState.ballPosition.y - gameState.leftPaddleY) / PADDLE_HEIGHT;             // Calculate reflection angle based on where ball hits paddle
-            float bounceAngle = (hitPosition - 0.5f) * PI/3; // Between -PI/6 and PI/6 radians
-            float currentSpeed = Vector2Length(gameState.ballVelocity);
-            float newSpeed = fmaxf(currentSpeed, INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f));
-            newSpeed = fminf(newSpeed * 1.05f, MAX_BALL_SPEED);
-            gameState.ballVelocity.x = fabs(newSpeed * cosf(bounceAngle)); // Force positive x direction
-            gameState.ballVelocity.y = newSpeed * sinf(bounceAngle);
-            gameState.ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;             // Move ball outside paddle to prevent multiple collisions
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
-        }
-        if (gameState.ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
-            gameState.ballPosition.y >= gameState.rightPaddleY && 
-            gameState.ballPosition.y <= gameState.rightPaddleY + PADDLE_HEIGHT) {
-            float hitPosition = (gameState.ballPosition.y - gameState.rightPaddleY) / PADDLE_HEIGHT;
-            float bounceAngle = (hitPosition - 0.5f) * PI/3; 
-            float currentSpeed = Vector2Length(gameState.ballVelocity);
-            float newSpeed = fmaxf(currentSpeed, INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f));
-            newSpeed = fminf(newSpeed * 1.05f, MAX_BALL_SPEED);
-            gameState.ballVelocity.x = -fabs(newSpeed * cosf(bounceAngle)); // Force negative x direction
-            gameState.ballVelocity.y = newSpeed * sinf(bounceAngle);
-            gameState.ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
-            PlaySound(LoadSound("resources/paddle_hit.wav"));
-        }
-        if (gameState.ballPosition.x < 0) {
-            gameState.rightScore++;
-            PlaySound(LoadSound("resources/score.wav"));
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;             // Reset ball with level-based speed
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;
-            gameState.ballVelocity.x = INITIAL_BALL_SPEED * levelSpeedMultiplier;
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
-                                      (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
-            if (gameState.rightScore >= MAX_SCORE) {
-                gameState.gameOver = true;
+RenderTexture2D renderTarget;       // Off-screen target at internal resolution, upscaled to the window
+float renderScale = 1.0f;
+bool autoRenderScale = false;
+float frameBudgetMs = 1000.0f / 60.0f;     // --frame-budget <ms>, for --auto-scale and the quality governor
+PongQuality quality;                // Main thread: trail, paddle corners, overlays and effects, --quality pins the tier
+bool showTelemetry = false;         // F3: quality tier, budget, frame work, FPS and render scale
+int renderFilter = TEXTURE_FILTER_POINT;
+typedef enum { SOUND_PADDLE, SOUND_WALL, SOUND_SCORE } SoundType;
+typedef struct {
+    SoundType type;
+    float pitch;        // Ball speed relative to INITIAL_BALL_SPEED
+    float pan;          // 0 = left edge, 1 = right edge
+    struct timespec postedAt;
+} SoundEvent;
+typedef struct {
+    SoundEvent events[SOUND_EVENT_CAPACITY];
+    atomic_uint head;   // Written by the producer only
+    atomic_uint tail;   // Written by the consumer only
+} SoundEventRing;
+typedef struct {
+    bool active;
+    SoundType type;
+    float frequency;
+    float phase;
+    float leftGain, rightGain;
+    int sample;
+    int length;
+} Voice;
+SoundEventRing soundEvents;
+Voice voices[MAX_VOICES];           // Only touched by the audio callback
+AudioStream synthStream;
+int audioBufferFrames = 256;
+double latencySumMs = 0.0, latencyMaxMs = 0.0;     // Event-to-audio latency, written by the audio callback
+long latencyCount = 0;
+PongJitterStats ballJitter = { .binUs = 50 };     // Written by ballThreadFunc only; 50 us bins up to 100 ms
+int ballCpu = -1, mainCpu = -1;     // --pin-ball/--pin-main, -1 = leave to the scheduler
+bool realtimePhysics = false;       // --rt: SCHED_FIFO for the ball thread
+bool lockMemory = false;            // --mlock
+bool jitterReport = false;          // --jitter-report
+struct timespec startTime;          // For the time-to-first-frame report
+bool firstFrameShown = false;
+typedef struct {
+    unsigned char* pixels;          // RGBA, bottom-up as read back from the record target
+    PongMatchSnapshot snapshot;     // State shown in the frame, for the .states log
+    int droppedBefore;              // Frames dropped just before this one, the encoder repeats it to keep the clip in time
+} RecordSlot;
+typedef struct {
+    RecordSlot slots[RECORD_RING_SLOTS];
+    atomic_uint head;   // Written by the main thread only
+    atomic_uint tail;   // Written by the encoder thread only
+} RecordRing;
+RecordRing recordRing;
+typedef enum { COMMAND_PADDLE, COMMAND_NEXT_LEVEL, COMMAND_RESTART, COMMAND_MENU, COMMAND_LOAD } CommandType;
+typedef struct {
+    int64_t timeNs;                 // CLOCK_MONOTONIC when the main loop issued it
+    int8_t type;                    // CommandType
+    int8_t side;                    // COMMAND_PADDLE: BOT_SIDE_LEFT/BOT_SIDE_RIGHT
+    int8_t direction;               // COMMAND_PADDLE: held from timeNs on, -1 up, 0 none, +1 down
+    PongMatchSnapshot* snapshot;    // COMMAND_LOAD: freed by ballThreadFunc
+} InputCommand;
+typedef struct {
+    InputCommand commands[INPUT_COMMAND_CAPACITY];
+    atomic_uint head;   // Written by the main thread only
+    atomic_uint tail;   // Written by ballThreadFunc only
+} InputCommandRing;
+InputCommandRing inputCommands;    // Everything the main loop asks of the simulation
+int sentDirection[2];               // Main thread: last direction queued per side
+int heldDirection[2];               // ballThreadFunc: direction in effect per side
+PongEvdev evdev;                    // --evdev [devices]: paddle keys read from /dev/input on their own thread, the main loop leaves them alone
+bool evdevInput = false;
+const char* evdevPaths = NULL;      // Comma-separated event devices, NULL scans /dev/input
+typedef struct {
+    float ms[INPUT_LATENCY_SAMPLES];
+    long count;
+    double maxMs;
+} LatencySamples;
+bool inputLatency = false;          // --input-latency: key press to paddle move, in the simulation and on screen
+LatencySamples pressToTick;         // ballThreadFunc only: press to the published tick that moved the paddle
+LatencySamples pressToScreen;       // Main thread only: press to the end of the first frame that shows that tick
+int64_t tickPressNs;                // ballThreadFunc: earliest press applied this tick, 0 = none
+_Atomic int64_t shownPressNs;       // A press waiting for the main loop to show it, 0 = none; set by ballThreadFunc, cleared by main
+atomic_ullong shownPressTick;       // The tick that applied it
+RenderTexture2D recordTargets[2];   // Alternated, so each readback is of a frame the GPU had a whole frame to finish
+PongMatchSnapshot recordSnapshots[2];
+long recordFrameIndex = 0;
+int pendingDrops = 0;
+long droppedFrames = 0;
+const char* recordPath = NULL;      // --record clip.y4m|clip.rle
+bool recording = false;             // F9 toggles it while --record is given
+atomic_bool encoderDone;
+VideoWriter clipWriter;             // Owned by the encoder thread while it runs
+FILE* statesFile = NULL;
+typedef struct {
+    double sumMs, maxMs;
+    long count;
+} FrameTimeStats;
+FrameTimeStats frameTimes[2];       // CPU time from beginFrame to EndDrawing, [0] recording off, [1] on
+struct timespec frameWorkStart;
+typedef struct {
+    RallyEvent events[RALLY_RING_CAPACITY];
+    atomic_uint head;   // Written by the producer only
+    atomic_uint tail;   // Written by the consumer only
+    atomic_long dropped;
+} RallyRing;
+RallyRing rallyEvents;              // One ring per producing thread; only ballThreadFunc produces
+const char* analyticsPath = NULL;   // --analytics <file>, appended to across sessions
+atomic_bool analyticsDone;
+uint32_t currentRally = 0, currentRallyHits = 0;     // ballThreadFunc only
+typedef struct {
+    MatchRecord results[RESULT_RING_CAPACITY];
+    atomic_uint head;   // Written by the producer only
+    atomic_uint tail;   // Written by the consumer only
+} ResultRing;
+typedef struct {
+    MatchRecord top[LEADERBOARD_SHOWN];
+    int topCount;
+    uint64_t matches, playerWins, cpuWins;
+    bool loaded;
+} LeaderboardView;
+ResultRing matchResults;
+const char* leaderboardPath = "leaderboard.log";     // --leaderboard <file>, "none" disables it
+atomic_bool leaderboardDone;
+pthread_mutex_t leaderboardMutex = PTHREAD_MUTEX_INITIALIZER;     // Guards publishedView only
+LeaderboardView publishedView;      // Written by the leaderboard thread
+LeaderboardView screenView;         // Main thread's copy, refreshed when the lock is free
+struct timespec matchStartTime;
+bool resultPosted = false;
+PongShmSegment* liveState = NULL;   // --export-state, written by ballThreadFunc only
+const char* liveStateName = PONG_SHM_NAME;
+uint64_t ballTicks = 0;
+BotLink botLinks[2];                // [BOT_SIDE_LEFT], [BOT_SIDE_RIGHT], used by ballThreadFunc once connected
+const char* botPaths[2] = { NULL, NULL };     // --bot-left/--bot-right <socket>
+bool lockstep = false;              // --lockstep: each tick waits for every bot's answer instead of the 16 ms timer
+uint64_t matchSeed = 0;             // --seed, 0 = time based
+const char* levelsPath = NULL;      // --levels <file>, NULL = the built-in three
+const char* snapshotPath = "pingpong.snap";     // F5 saves, F8 loads; also written when the window closes mid-match
+const char* resumePath = NULL;      // --resume <snapshot or .states log>
+long resumeFrame = 0;               // --resume-at <frame> in a .states log
+atomic_bool workersDone;            // Set on exit: the ball thread finishes its tick and returns
+float rematchAfterSeconds = -1.0f;  // --rematch-after <s>: restart on its own after game over, -1 = wait for R
+struct timespec gameOverTime;       // When the current game-over screen appeared
+typedef struct {
+    long count, firstTicks;
+    double resetSumUs, resetMaxUs;  // restartMatch() itself
+    double firstTickSumMs, firstTickMaxMs;     // Restart to the new match's first ball tick
+} RestartStats;
+RestartStats restartStats;          // Written by ballThreadFunc, printed after it is joined
+int64_t restartTimeNs;              // ballThreadFunc: when the restart it is waiting to run a first tick for was asked for
+bool awaitingFirstTick = false;
+unsigned int awaitedCommand = 0;    // Main thread: ring position just past its last restart or load
+bool perfCounters = false;          // --perf-counters: cache misses and context switches per ball tick
+const char* tracePath = NULL;       // --trace <file.json>: F10 writes the zones so far, closing the window writes them all
+typedef struct {
+    int cacheMissFd, switchFd;      // -1 when perf_event_open is not allowed
+    long ticks;
+    uint64_t cacheMisses, contextSwitches;
+    double workNs;
+} TickCounters;
+TickCounters tickCounters;          // ballThreadFunc only
+PongAiController cpuAi;             // The right paddle in single player, stepped by ballThreadFunc
+PongMatchSnapshot attract;          // Main thread: the CPU vs CPU match behind the mode selection menu
+PongAiController attractAis[2];     // Left and right CPU
+long attractTicks = 0;
+PongBench bench;                    // --bench [frames]: play the attract scene unthrottled, report and quit
+void postSoundEvent(SoundType type, float speed, float x) { // Lock-free, called from ballThreadFunc only
+    unsigned int head = atomic_load_explicit(&soundEvents.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&soundEvents.tail, memory_order_acquire) == SOUND_EVENT_CAPACITY) return;  // Full, drop
+    SoundEvent* event = &soundEvents.events[head % SOUND_EVENT_CAPACITY];
+    event->type = type;
+    event->pitch = speed / INITIAL_BALL_SPEED;
+    event->pan = fminf(fmaxf(x / SCREEN_WIDTH, 0.0f), 1.0f);
+    clock_gettime(CLOCK_MONOTONIC, &event->postedAt);
+    atomic_store_explicit(&soundEvents.head, head + 1, memory_order_release);
+}
+void startVoice(const SoundEvent* event) {
+    Voice* voice = &voices[0];
+    for (int i = 0; i < MAX_VOICES; i++) {     // Take a free voice, or steal the one furthest along
+        if (!voices[i].active) { voice = &voices[i]; break; }
+        if ((float)voices[i].sample / voices[i].length > (float)voice->sample / voice->length) voice = &voices[i];
+    }
+    voice->active = true;
+    voice->type = event->type;
+    voice->phase = 0.0f;
+    voice->sample = 0;
+    voice->leftGain = cosf(event->pan * PI / 2);     // Equal-power pan
+    voice->rightGain = sinf(event->pan * PI / 2);
+    switch (event->type) {
+        case SOUND_PADDLE:
+            voice->frequency = 440.0f * event->pitch;
+            voice->length = AUDIO_SAMPLE_RATE * 60 / 1000;
+            break;
+        case SOUND_WALL:
+            voice->frequency = 220.0f * event->pitch;
+            voice->length = AUDIO_SAMPLE_RATE * 40 / 1000;
+            break;
+        case SOUND_SCORE:
+            voice->frequency = 660.0f;
+            voice->length = AUDIO_SAMPLE_RATE * 300 / 1000;
+            break;
+    }
+}
+void synthCallback(void* buffer, unsigned int frames) { // Runs on the audio thread, must not block or allocate
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    unsigned int tail = atomic_load_explicit(&soundEvents.tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&soundEvents.head, memory_order_acquire);
+    for (; tail != head; tail++) {
+        SoundEvent* event = &soundEvents.events[tail % SOUND_EVENT_CAPACITY];
+        double latencyMs = (now.tv_sec - event->postedAt.tv_sec) * 1000.0 + (now.tv_nsec - event->postedAt.tv_nsec) / 1e6 +
+                           audioBufferFrames * 1000.0 / AUDIO_SAMPLE_RATE;   // Plus the buffer ahead of it in the device
+        latencySumMs += latencyMs;
+        if (latencyMs > latencyMaxMs) latencyMaxMs = latencyMs;
+        latencyCount++;
+        startVoice(event);
+    }
+    atomic_store_explicit(&soundEvents.tail, tail, memory_order_release);
+    float* out = (float*)buffer;
+    for (unsigned int i = 0; i < frames; i++) {
+        float left = 0.0f, right = 0.0f;
+        for (int v = 0; v < MAX_VOICES; v++) {
+            Voice* voice = &voices[v];
+            if (!voice->active) continue;
+            float t = (float)voice->sample / voice->length;
+            float value;
+            if (voice->type == SOUND_SCORE) {     // Falling sweep
+                value = sinf(voice->phase) * (1.0f - t);
+                voice->phase += 2 * PI * voice->frequency * (1.0f - 0.5f * t) / AUDIO_SAMPLE_RATE;
+            } else if (voice->type == SOUND_PADDLE) {     // Square blip with fast decay
+                value = (voice->phase < PI ? 0.5f : -0.5f) * expf(-6.0f * t);
+                voice->phase += 2 * PI * voice->frequency / AUDIO_SAMPLE_RATE;
+            } else {     // Soft sine thud
+                value = sinf(voice->phase) * expf(-8.0f * t);
+                voice->phase += 2 * PI * voice->frequency / AUDIO_SAMPLE_RATE;
             }
+            if (voice->phase >= 2 * PI) voice->phase -= 2 * PI;
+            left += value * voice->leftGain;
+            right += value * voice->rightGain;
+            if (++voice->sample >= voice->length) voice->active = false;
+        }
+        out[2 * i] = fminf(fmaxf(left * 0.3f, -1.0f), 1.0f);
+        out[2 * i + 1] = fminf(fmaxf(right * 0.3f, -1.0f), 1.0f);
+    }
+}
+void postRallyEvent(RallyEventType type, const PongMatch* match, uint64_t timeNs) { // Lock-free, called from ballThreadFunc only
+    unsigned int head = atomic_load_explicit(&rallyEvents.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&rallyEvents.tail, memory_order_acquire) == RALLY_RING_CAPACITY) {
+        atomic_fetch_add_explicit(&rallyEvents.dropped, 1, memory_order_relaxed);     // Flusher is behind, never wait for it
+        return;
+    }
+    RallyEvent* event = &rallyEvents.events[head % RALLY_RING_CAPACITY];
+    event->timeNs = timeNs;
+    event->rally = currentRally;
+    event->rallyHits = currentRallyHits;
+    event->hitPosition = 0.0f;
+    event->bounceAngle = 0.0f;
+    if (type == RALLY_LEFT_HIT || type == RALLY_RIGHT_HIT) {     // Same formula as pongStepBall, from the post-hit state
+        float paddleY = (type == RALLY_LEFT_HIT) ? match->leftPaddleY : match->rightPaddleY;
+        event->hitPosition = (match->ballPosition.y - paddleY) / PADDLE_HEIGHT;
+        event->bounceAngle = (event->hitPosition - 0.5f) * PI/3;
+    }
+    event->speed = pongSpeed(match->ballVelocity);
+    event->x = match->ballPosition.x;
+    event->y = match->ballPosition.y;
+    event->type = type;
+    event->level = match->level;
+    event->leftScore = match->leftScore;
+    event->rightScore = match->rightScore;
+    atomic_store_explicit(&rallyEvents.head, head + 1, memory_order_release);
+}
+void* analyticsThreadFunc(void* arg) { // Batches rally events into column blocks, appended to the analytics file
+    FILE* file = arg;
+    pongTraceThread("Analytics");
+    static RallyEvent batch[RALLY_BLOCK_ROWS];
+    uint32_t rows = 0;
+    long idleMs = 0;
+    while (true) {
+        bool done = atomic_load(&analyticsDone);     // Read before draining, so nothing posted before the stop is lost
+        unsigned int tail = atomic_load_explicit(&rallyEvents.tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&rallyEvents.head, memory_order_acquire);
+        while (tail != head && rows < RALLY_BLOCK_ROWS) batch[rows++] = rallyEvents.events[tail++ % RALLY_RING_CAPACITY];
+        atomic_store_explicit(&rallyEvents.tail, tail, memory_order_release);
+        if (rows == RALLY_BLOCK_ROWS || (rows > 0 && (idleMs >= RALLY_FLUSH_MS || done))) {
+            PONG_ZONE("write rally block");
+            rallyWriteBlock(file, batch, rows);
+            fflush(file);
+            rows = 0;
+            idleMs = 0;
         }
-        if (gameState.ballPosition.x > SCREEN_WIDTH) {
-            gameState.leftScore++;
-            PlaySound(LoadSound("resources/score.wav"));
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;
-            gameState.ballVelocity.x = -INITIAL_BALL_SPEED * levelSpeedMultiplier;
-            gameState.ballVelocity.y = INITIAL_BALL_SPEED * (GetRandomValue(0, 1) ? 1 : -1) * 
-                                      (0.6f + ((float)GetRandomValue(0, 40) / 100.0f)) * levelSpeedMultiplier;
-            if (gameState.leftScore >= MAX_SCORE) {
-                gameState.gameOver = true;
+        if (done && tail == atomic_load_explicit(&rallyEvents.head, memory_order_acquire)) break;
+        if (tail == head) {
+            usleep(50000);
+            idleMs += 50;
+        }
+    }
+    fclose(file);
+    return NULL;
+}
+void postMatchResult(const PongMatchSnapshot* view) { // Main thread at the game-over screen; never waits on the leaderboard thread
+    unsigned int head = atomic_load_explicit(&matchResults.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&matchResults.tail, memory_order_acquire) == RESULT_RING_CAPACITY) return;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    MatchRecord* record = &matchResults.results[head % RESULT_RING_CAPACITY];
+    memset(record, 0, sizeof(*record));
+    record->endTime = time(NULL);
+    record->durationMs = (now.tv_sec - matchStartTime.tv_sec) * 1000 + (now.tv_nsec - matchStartTime.tv_nsec) / 1000000;
+    record->twoPlayer = view->twoPlayerMode;
+    record->level = view->match.level;
+    record->leftScore = view->match.leftScore;
+    record->rightScore = view->match.rightScore;
+    atomic_store_explicit(&matchResults.head, head + 1, memory_order_release);
+}
+void publishLeaderboard(const Leaderboard* board) {
+    LeaderboardView view;
+    view.topCount = leaderboardTop(board, view.top, LEADERBOARD_SHOWN);
+    view.matches = board->count;
+    view.playerWins = board->playerWins;
+    view.cpuWins = board->cpuWins;
+    view.loaded = true;
+    pthread_mutex_lock(&leaderboardMutex);
+    publishedView = view;
+    pthread_mutex_unlock(&leaderboardMutex);
+}
+void* leaderboardThreadFunc(void* arg) { // Owns the log, so loading, appends, remaps and snapshots stay off the render loop
+    static Leaderboard board;
+    pongTraceThread("Leaderboard");
+    if (!leaderboardOpen(&board, leaderboardPath)) {
+        printf("Cannot open leaderboard %s\n", leaderboardPath);
+        return NULL;
+    }
+    printf("Leaderboard: %llu matches, %llu replayed from the log after the last index snapshot\n",
+           (unsigned long long)board.count, (unsigned long long)board.replayed);
+    publishLeaderboard(&board);
+    int sinceSnapshot = 0;
+    while (true) {
+        bool done = atomic_load(&leaderboardDone);     // Read before draining, so a result posted before the stop is kept
+        unsigned int tail = atomic_load_explicit(&matchResults.tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&matchResults.head, memory_order_acquire);
+        if (tail != head) {
+            PONG_ZONE("append results");
+            for (; tail != head; tail++) {
+                if (leaderboardAppend(&board, matchResults.results[tail % RESULT_RING_CAPACITY])) sinceSnapshot++;
             }
+            atomic_store_explicit(&matchResults.tail, tail, memory_order_release);
+            publishLeaderboard(&board);
+        }
+        if (sinceSnapshot >= LEADERBOARD_SNAPSHOT_EVERY) {
+            PONG_ZONE("index snapshot");
+            leaderboardSnapshot(&board);
+            sinceSnapshot = 0;
         }
-        pthread_mutex_unlock(&gameState.stateMutex);
+        if (done) break;
+        usleep(50000);
     }
+    leaderboardClose(&board);     // Final snapshot, so the next start reads only the index
     return NULL;
 }
-void* aiThreadFunc(void* arg) { // AI (Right Paddle)
-    while (1) {
-        usleep(16000); // thinking time
-        pthread_mutex_lock(&gameState.stateMutex);
-        if (gameState.twoPlayerMode || gameState.gameOver || gameState.gamePaused || !gameState.modeSelected) {         // Skip AI control if in two-player mode or game is paused/over/not started
-            pthread_mutex_unlock(&gameState.stateMutex);
+void exportLiveState(const struct timespec* now) { // ballThreadFunc, right after publishMatch; readers never block it
+    PongLiveState state;
+    state.tick = ballTicks;
+    state.timeNs = (int64_t)now->tv_sec * 1000000000 + now->tv_nsec;
+    const PongMatchSnapshot* published = &gameState.published;     // Safe unguarded: only this thread writes it
+    state.ballX = published->match.ballPosition.x;
+    state.ballY = published->match.ballPosition.y;
+    state.ballVelocityX = published->match.ballVelocity.x;
+    state.ballVelocityY = published->match.ballVelocity.y;
+    state.leftPaddleY = published->match.leftPaddleY;
+    state.rightPaddleY = published->match.rightPaddleY;
+    state.leftScore = published->match.leftScore;
+    state.rightScore = published->match.rightScore;
+    state.level = published->match.level;
+    state.twoPlayer = published->twoPlayerMode;
+    state.paused = published->gamePaused;
+    state.gameOver = published->match.gameOver;
+    state.modeSelected = published->modeSelected;
+    pongShmPublish(liveState, &state);
+}
+bool botControls(int side) {
+    return botLinks[side].connected;
+}
+int64_t timespecNs(const struct timespec* time) {
+    return (int64_t)time->tv_sec * 1000000000 + time->tv_nsec;
+}
+double microsecondsSince(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e6 + (now.tv_nsec - start->tv_nsec) / 1e3;
+}
+bool postCommand(InputCommand command) { // Main thread only; stamps the command, false when the ring is full
+    unsigned int head = atomic_load_explicit(&inputCommands.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&inputCommands.tail, memory_order_acquire) == INPUT_COMMAND_CAPACITY) return false;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    command.timeNs = timespecNs(&now);
+    inputCommands.commands[head % INPUT_COMMAND_CAPACITY] = command;
+    atomic_store_explicit(&inputCommands.head, head + 1, memory_order_release);
+    if (command.type == COMMAND_RESTART || command.type == COMMAND_MENU || command.type == COMMAND_LOAD) awaitedCommand = head + 1;
+    return true;
+}
+void publishMatch() { // ballThreadFunc after every tick (and main before it starts): seqlock write, never waits for readers
+    unsigned int sequence = atomic_load_explicit(&gameState.publishedSequence, memory_order_relaxed);
+    atomic_store_explicit(&gameState.publishedSequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    gameState.published = (PongMatchSnapshot){ .match = gameState.match, .ballTicks = ballTicks,
+        .twoPlayerMode = atomic_load_explicit(&gameState.twoPlayerMode, memory_order_acquire),
+        .gamePaused = atomic_load_explicit(&gameState.gamePaused, memory_order_acquire),
+        .modeSelected = atomic_load_explicit(&gameState.modeSelected, memory_order_acquire) };
+    gameState.publishedCommands = atomic_load_explicit(&inputCommands.tail, memory_order_relaxed);
+    atomic_store_explicit(&gameState.publishedSequence, sequence + 2, memory_order_release);
+}
+PongMatchSnapshot readPublished(unsigned int* commandsApplied) { // Any thread but ballThreadFunc: retries a copy torn by a tick, never blocks the writer
+    PongMatchSnapshot view;
+    unsigned int commands;
+    while (true) {
+        unsigned int before = atomic_load_explicit(&gameState.publishedSequence, memory_order_acquire);
+        if (before & 1) {
+            sched_yield();           // Writer is mid-copy; on one core it needs the CPU to finish
+            continue;
+        }
+        memcpy(&view, (const void*)&gameState.published, sizeof(view));
+        commands = gameState.publishedCommands;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&gameState.publishedSequence, memory_order_relaxed) == before) {
+            if (commandsApplied) *commandsApplied = commands;
+            return view;
+        }
+    }
+}
+void resetCpu() { // ballThreadFunc: a new or loaded match starts the CPU with no sightings, seeded from the match
+    pongAiInit(&cpuAi, false, gameState.match.rng.state ^ 0x9e3779b97f4a7c15ull);
+}
+void runCommand(const InputCommand* command) { // ballThreadFunc: everything but paddle moves, in the order the main loop sent them
+    switch (command->type) {
+        case COMMAND_NEXT_LEVEL:
+            if (!gameState.match.gameOver) gameState.match.level = (gameState.match.level % pongLevelCount) + 1;
+            break;
+        case COMMAND_RESTART:
+        case COMMAND_MENU: {         // Resets the match only, threads, audio and textures stay up
+            struct timespec started;
+            clock_gettime(CLOCK_MONOTONIC, &started);
+            pongInitMatch(&gameState.match, gameState.match.level, gameState.match.rng.state);     // Same RNG stream, so seeded sessions replay
+            resetCpu();
+            currentRallyHits = 0;
+            restartTimeNs = command->timeNs;
+            awaitingFirstTick = command->type == COMMAND_RESTART;
+            double resetUs = microsecondsSince(&started);
+            restartStats.count++;
+            restartStats.resetSumUs += resetUs;
+            if (resetUs > restartStats.resetMaxUs) restartStats.resetMaxUs = resetUs;
+            break;
+        }
+        case COMMAND_LOAD:
+            gameState.match = command->snapshot->match;
+            ballTicks = command->snapshot->ballTicks;
+            resetCpu();
+            free(command->snapshot);
+            break;
+    }
+}
+void sampleInput() { // Main thread, once per frame: queues held-key changes, the paddles themselves are only moved by ballThreadFunc
+    int wanted[2];
+    bool evdevLive = evdevInput && atomic_load_explicit(&evdev.live, memory_order_relaxed) > 0;     // Then the evdev thread queues them straight to ballThreadFunc
+    wanted[BOT_SIDE_LEFT] = evdevLive || botControls(BOT_SIDE_LEFT) ? 0 : IsKeyDown(KEY_S) - IsKeyDown(KEY_W);
+    wanted[BOT_SIDE_RIGHT] = !evdevLive && atomic_load_explicit(&gameState.twoPlayerMode, memory_order_relaxed) && !botControls(BOT_SIDE_RIGHT) ? IsKeyDown(KEY_DOWN) - IsKeyDown(KEY_UP) : 0;
+    for (int side = 0; side < 2; side++) {
+        if (wanted[side] != sentDirection[side] && postCommand((InputCommand){ .type = COMMAND_PADDLE, .side = side, .direction = wanted[side] })) {
+            sentDirection[side] = wanted[side];     // Full ring: retried next frame
+        }
+    }
+}
+void addLatency(LatencySamples* samples, double ms) {
+    if (samples->count < INPUT_LATENCY_SAMPLES) samples->ms[samples->count] = (float)ms;
+    if (ms > samples->maxMs) samples->maxMs = ms;
+    samples->count++;
+}
+void printLatency(LatencySamples* samples, const char* what) {
+    long kept = samples->count < INPUT_LATENCY_SAMPLES ? samples->count : INPUT_LATENCY_SAMPLES;
+    if (kept == 0) return;
+    qsort(samples->ms, kept, sizeof(float), pongBenchCompare);
+    printf("Key press to %s: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms over %ld presses\n", what, samples->ms[kept / 2],
+           samples->ms[kept * 90 / 100], samples->ms[kept * 99 / 100], samples->maxMs, samples->count);
+}
+void changeHeldDirection(int side, int direction, int64_t timeNs, int64_t tickStartNs, int64_t* segmentStart, float* moved) { // ballThreadFunc
+    const float pixelsPerNs = PADDLE_SPEED_PER_SECOND / 1e9f;
+    int64_t at = timeNs > tickStartNs ? timeNs : tickStartNs;
+    moved[side] += heldDirection[side] * (at - segmentStart[side]) * pixelsPerNs;
+    segmentStart[side] = at;
+    bool playerSide = side == BOT_SIDE_LEFT || atomic_load_explicit(&gameState.twoPlayerMode, memory_order_relaxed);
+    if (playerSide && direction != 0 && direction != heldDirection[side] && (tickPressNs == 0 || timeNs < tickPressNs)) tickPressNs = timeNs;
+    heldDirection[side] = direction;
+}
+void recordPressLatency() { // ballThreadFunc, after a running tick is published
+    if (tickPressNs == 0) return;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    addLatency(&pressToTick, (timespecNs(&now) - tickPressNs) / 1e6);
+    if (atomic_load_explicit(&shownPressNs, memory_order_acquire) == 0) {     // One press in flight to the screen at a time
+        atomic_store_explicit(&shownPressTick, ballTicks, memory_order_relaxed);
+        atomic_store_explicit(&shownPressNs, tickPressNs, memory_order_release);
+    }
+    tickPressNs = 0;
+}
+void recordScreenLatency(uint64_t shownTick) { // Main thread, after the frame showing shownTick is swapped
+    int64_t pressNs = atomic_load_explicit(&shownPressNs, memory_order_acquire);
+    if (pressNs == 0 || shownTick < atomic_load_explicit(&shownPressTick, memory_order_relaxed)) return;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    addLatency(&pressToScreen, (timespecNs(&now) - pressNs) / 1e6);
+    atomic_store_explicit(&shownPressNs, 0, memory_order_release);
+}
+void applyInputCommands(int64_t tickStartNs, int64_t tickEndNs) { // ballThreadFunc, at the start of each tick
+    const float pixelsPerNs = PADDLE_SPEED_PER_SECOND / 1e9f;
+    int64_t segmentStart[2] = { tickStartNs, tickStartNs };
+    float moved[2] = { 0.0f, 0.0f };
+    unsigned int tail = atomic_load_explicit(&inputCommands.tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&inputCommands.head, memory_order_acquire);
+    for (; tail != head; tail++) {     // Each change splits the tick, so a key held for half a tick moves half as far
+        const InputCommand* command = &inputCommands.commands[tail % INPUT_COMMAND_CAPACITY];
+        if (command->timeNs > tickEndNs) break;     // Belongs to the next tick
+        if (command->type != COMMAND_PADDLE) {
+            runCommand(command);
+            continue;
+        }
+        changeHeldDirection(command->side, command->direction, command->timeNs, tickStartNs, segmentStart, moved);
+    }
+    atomic_store_explicit(&inputCommands.tail, tail, memory_order_release);
+    PongKeyEvent key;                // Read here, at the tick, so a press reaches the paddles within a tick of the kernel seeing it
+    while (evdevInput && pongEvdevPeek(&evdev, &key) && key.timeNs <= tickEndNs) {
+        if (!botControls(key.side)) changeHeldDirection(key.side, key.direction, key.timeNs, tickStartNs, segmentStart, moved);
+        pongEvdevPop(&evdev);
+    }
+    bool twoPlayerMode = atomic_load_explicit(&gameState.twoPlayerMode, memory_order_acquire);
+    if (gameState.match.gameOver || atomic_load_explicit(&gameState.gamePaused, memory_order_acquire) ||
+        !atomic_load_explicit(&gameState.modeSelected, memory_order_acquire)) {     // Commands still drained, so held keys stay current
+        tickPressNs = 0;
+        return;
+    }
+    moved[BOT_SIDE_LEFT] += heldDirection[BOT_SIDE_LEFT] * (tickEndNs - segmentStart[BOT_SIDE_LEFT]) * pixelsPerNs;
+    moved[BOT_SIDE_RIGHT] += heldDirection[BOT_SIDE_RIGHT] * (tickEndNs - segmentStart[BOT_SIDE_RIGHT]) * pixelsPerNs;
+    if (moved[BOT_SIDE_LEFT] != 0.0f) {
+        gameState.match.leftPaddleY += moved[BOT_SIDE_LEFT];
+        pongClampPaddle(&gameState.match.leftPaddleY);
+    }
+    if (moved[BOT_SIDE_RIGHT] != 0.0f && twoPlayerMode) {
+        gameState.match.rightPaddleY += moved[BOT_SIDE_RIGHT];
+        pongClampPaddle(&gameState.match.rightPaddleY);
+    }
+}
+void applyBotMoves() { // ballThreadFunc: the latest command of each bot moves its paddle for this tick
+    for (int side = 0; side < 2; side++) {
+        if (!botLinks[side].connected) continue;
+        float move = fmaxf(-PADDLE_SPEED, fminf(PADDLE_SPEED, botLinks[side].move));
+        float* paddleY = (side == BOT_SIDE_LEFT) ? &gameState.match.leftPaddleY : &gameState.match.rightPaddleY;
+        *paddleY += move;
+        pongClampPaddle(paddleY);
+    }
+}
+void exchangeWithBots(const PongMatch* match, int flags) { // ballThreadFunc, after the tick is published: send its state, collect answers
+    for (int side = 0; side < 2; side++) {
+        if (!botLinks[side].connected) continue;
+        BotStateMessage message = {
+            .tick = (uint32_t)ballTicks, .side = side, .flags = flags | (lockstep ? BOT_FLAG_LOCKSTEP : 0),
+            .leftScore = match->leftScore, .rightScore = match->rightScore,
+            .ballX = match->ballPosition.x, .ballY = match->ballPosition.y,
+            .ballVelocityX = match->ballVelocity.x, .ballVelocityY = match->ballVelocity.y,
+            .paddleY = side == BOT_SIDE_LEFT ? match->leftPaddleY : match->rightPaddleY,
+            .opponentPaddleY = side == BOT_SIDE_LEFT ? match->rightPaddleY : match->leftPaddleY
+        };
+        botSendState(&botLinks[side], &message);
+    }
+    for (int side = 0; side < 2; side++) {     // Lockstep waits only while the game is running
+        if (botLinks[side].connected) botPoll(&botLinks[side], -1, lockstep && flags == 0, (uint32_t)ballTicks);
+    }
+}
+int openTickCounter(uint32_t type, uint64_t config) { // This thread only, user and kernel; -1 when perf events are not allowed
+    struct perf_event_attr attributes = { .type = type, .size = sizeof(attributes), .config = config };
+    return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+uint64_t readTickCounter(int fd) {
+    uint64_t value = 0;
+    if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value)) value = 0;
+    return value;
+}
+void* ballThreadFunc(void* arg) {
+    pongTraceThread("Ball");
+    struct timespec lastTick, now, workDone;
+    clock_gettime(CLOCK_MONOTONIC, &lastTick);
+    if (perfCounters) {
+        tickCounters.cacheMissFd = openTickCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        tickCounters.switchFd = openTickCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+        if (tickCounters.cacheMissFd < 0 && tickCounters.switchFd < 0) printf("perf_event_open: %s\n", strerror(errno));
+    }
+    while (!atomic_load(&workersDone)) {
+        bool running = !gameState.match.gameOver && !atomic_load(&gameState.gamePaused) && atomic_load(&gameState.modeSelected);     // Only picks the pacing
+        bool pacedByBots = lockstep && running && (botControls(BOT_SIDE_LEFT) || botControls(BOT_SIDE_RIGHT));
+        if (!pacedByBots) usleep(BALL_TICK_US); // ~60 updates per second; lockstep is paced by the bots while one is connected
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        pongRecordTickInterval(&ballJitter, (now.tv_sec - lastTick.tv_sec) * 1e6 + (now.tv_nsec - lastTick.tv_nsec) / 1e3);
+        int64_t tickStartNs = timespecNs(&lastTick), tickEndNs = timespecNs(&now);
+        lastTick = now;
+        uint64_t missesBefore = readTickCounter(tickCounters.cacheMissFd), switchesBefore = readTickCounter(tickCounters.switchFd);
+        ballTicks++;
+        PONG_ZONE("tick");
+        PongTraceZone zone = pongTraceBegin("input commands");
+        applyInputCommands(tickStartNs, tickEndNs);
+        pongTraceEnd(&zone);
+        if (gameState.match.gameOver || atomic_load_explicit(&gameState.gamePaused, memory_order_acquire) ||
+            !atomic_load_explicit(&gameState.modeSelected, memory_order_acquire)) {         // Skip if game is paused, over, or mode not selected
+            publishMatch();
+            if (liveState) exportLiveState(&now);
+            exchangeWithBots(&gameState.match, (gameState.match.gameOver ? BOT_FLAG_GAME_OVER : 0) |
+                             BOT_FLAG_PAUSED * (gameState.published.gamePaused || !gameState.published.modeSelected));
             continue;
         }
-        float difficultyFactor = 0.4f + (gameState.level * 0.25f); // Level 1: 0.65, Level 2: 0.9, Level 3: 1.15
-        if (gameState.ballVelocity.x > 0) { 
-            float targetY = gameState.ballPosition.y;
-            if (gameState.level > 1) {
-                float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - gameState.ballPosition.x) / gameState.ballVelocity.x;
-                float predictedY = gameState.ballPosition.y + (gameState.ballVelocity.y * timeToReach);
-                while (predictedY < 0 || predictedY > SCREEN_HEIGHT) {
-                    if (predictedY < 0) predictedY = -predictedY;
-                    if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
-                }
-                targetY = predictedY * difficultyFactor + gameState.ballPosition.y * (1 - difficultyFactor);
+        if (awaitingFirstTick) {
+            double latencyMs = (tickEndNs - restartTimeNs) / 1e6;
+            restartStats.firstTickSumMs += latencyMs;
+            if (latencyMs > restartStats.firstTickMaxMs) restartStats.firstTickMaxMs = latencyMs;
+            restartStats.firstTicks++;
+            awaitingFirstTick = false;
+        }
+        applyBotMoves();
+        bool cpuPaddle = !botControls(BOT_SIDE_RIGHT) && !atomic_load_explicit(&gameState.twoPlayerMode, memory_order_acquire);
+        if (cpuPaddle) {             // The CPU is a tick function on this thread: same play at any load, and seeded runs replay
+            zone = pongTraceBegin("cpu prediction");
+            gameState.match.rightPaddleY += pongAiTick(&cpuAi, &gameState.match);
+            pongClampPaddle(&gameState.match.rightPaddleY);
+            pongTraceEnd(&zone);
+        }
+        zone = pongTraceBegin("collision and scoring");
+        int events = pongStepBall(&gameState.match);
+        pongTraceEnd(&zone);
+        zone = pongTraceBegin("rally and sound events");
+        if (analyticsPath && events) {
+            uint64_t timeNs = (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+            if (events & PONG_EVENT_WALL) postRallyEvent(RALLY_WALL, &gameState.match, timeNs);
+            if (events & PONG_EVENT_LEFT_PADDLE) {
+                currentRallyHits++;
+                postRallyEvent(RALLY_LEFT_HIT, &gameState.match, timeNs);
             }
-            float errorRange = (4.0f - gameState.level) * 25.0f;  // Level 1: 75, Level 2: 50, Level 3: 25
-            targetY += (GetRandomValue(-100, 100) / 100.0f) * errorRange;
-            float aiSpeed = PADDLE_SPEED * (0.8f + gameState.level * 0.2f);  // Level-based speed
-            if (targetY < gameState.rightPaddleY + PADDLE_HEIGHT/2 - 10) {
-                gameState.rightPaddleY -= aiSpeed * difficultyFactor;
-            } else if (targetY > gameState.rightPaddleY + PADDLE_HEIGHT/2 + 10) {
-                gameState.rightPaddleY += aiSpeed * difficultyFactor;
+            if (events & PONG_EVENT_RIGHT_PADDLE) {
+                currentRallyHits++;
+                postRallyEvent(RALLY_RIGHT_HIT, &gameState.match, timeNs);
             }
-        } else {
-            if (gameState.rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) {
-                gameState.rightPaddleY += PADDLE_SPEED * 0.5f;
-            } else if (gameState.rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) {
-                gameState.rightPaddleY -= PADDLE_SPEED * 0.5f;
+            if (events & (PONG_EVENT_LEFT_SCORED | PONG_EVENT_RIGHT_SCORED)) {
+                postRallyEvent((events & PONG_EVENT_LEFT_SCORED) ? RALLY_LEFT_SCORED : RALLY_RIGHT_SCORED, &gameState.match, timeNs);
+                currentRally++;
+                currentRallyHits = 0;
             }
         }
-        if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
-        if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
-        pthread_mutex_unlock(&gameState.stateMutex);
-        // Level 1: slow reactions, Level 3: quick reactions
-        int reactionTimeMs = 80 - (gameState.level * 25);  // Level 1: 55ms, Level 2: 30ms, Level 3: 5ms
-        usleep(reactionTimeMs * 1000);
+        float speed = pongSpeed(gameState.match.ballVelocity);
+        if (events & PONG_EVENT_WALL) postSoundEvent(SOUND_WALL, speed, gameState.match.ballPosition.x);
+        if (events & (PONG_EVENT_LEFT_PADDLE | PONG_EVENT_RIGHT_PADDLE)) postSoundEvent(SOUND_PADDLE, speed, gameState.match.ballPosition.x);
+        if (events & PONG_EVENT_RIGHT_SCORED) postSoundEvent(SOUND_SCORE, INITIAL_BALL_SPEED, 0);
+        if (events & PONG_EVENT_LEFT_SCORED) postSoundEvent(SOUND_SCORE, INITIAL_BALL_SPEED, SCREEN_WIDTH);
+        pongTraceEnd(&zone);
+        zone = pongTraceBegin("publish");
+        publishMatch();
+        if (inputLatency) recordPressLatency();
+        if (liveState) exportLiveState(&now);
+        pongTraceEnd(&zone);
+        if (perfCounters) {          // Tick work only: the sleep and the bot round trip are left out
+            clock_gettime(CLOCK_MONOTONIC, &workDone);
+            tickCounters.ticks++;
+            tickCounters.workNs += timespecNs(&workDone) - tickEndNs;
+            tickCounters.cacheMisses += readTickCounter(tickCounters.cacheMissFd) - missesBefore;
+            tickCounters.contextSwitches += readTickCounter(tickCounters.switchFd) - switchesBefore;
+        }
+        zone = pongTraceBegin("bot exchange");
+        exchangeWithBots(&gameState.match, gameState.match.gameOver ? BOT_FLAG_GAME_OVER : 0);
+        pongTraceEnd(&zone);
     }
     return NULL;
 }
-void drawModeSelection() {
+void applySnapshot(const PongMatchSnapshot* snapshot) { // Main thread: its own flags now, the match on the ball thread's next tick
+    PongMatchSnapshot* copy = malloc(sizeof(*copy));
+    *copy = *snapshot;
+    if (!postCommand((InputCommand){ .type = COMMAND_LOAD, .snapshot = copy })) {
+        free(copy);
+        return;
+    }
+    atomic_store_explicit(&gameState.twoPlayerMode, snapshot->twoPlayerMode, memory_order_release);
+    atomic_store_explicit(&gameState.gamePaused, snapshot->gamePaused, memory_order_release);
+    atomic_store_explicit(&gameState.modeSelected, snapshot->modeSelected, memory_order_release);
+    resultPosted = snapshot->match.gameOver;     // A resumed game-over screen was already counted
+    clock_gettime(CLOCK_MONOTONIC, &matchStartTime);
+    gameOverTime = matchStartTime;
+}
+void restartMatch(bool toModeSelection) { // Main thread: the ball thread resets the match on its next tick
+    if (!postCommand((InputCommand){ .type = toModeSelection ? COMMAND_MENU : COMMAND_RESTART })) return;
+    atomic_store_explicit(&gameState.gamePaused, false, memory_order_release);
+    if (toModeSelection) atomic_store_explicit(&gameState.modeSelected, false, memory_order_release);
+    resultPosted = false;
+    clock_gettime(CLOCK_MONOTONIC, &matchStartTime);
+}
+void* encoderThreadFunc(void* arg) { // Drains recordRing into the clip and its .states log
+    pongTraceThread("Encoder");
+    while (true) {
+        unsigned int tail = atomic_load_explicit(&recordRing.tail, memory_order_relaxed);
+        if (tail == atomic_load_explicit(&recordRing.head, memory_order_acquire)) {
+            if (atomic_load(&encoderDone)) break;
+            usleep(2000);
+            continue;
+        }
+        RecordSlot* slot = &recordRing.slots[tail % RECORD_RING_SLOTS];
+        PONG_ZONE("encode frame");
+        for (int i = 0; i <= slot->droppedBefore; i++) {
+            pongVideoWrite(&clipWriter, slot->pixels, RECORD_WIDTH * 4, true);
+            fwrite(&slot->snapshot, sizeof(PongMatchSnapshot), 1, statesFile);
+        }
+        atomic_store_explicit(&recordRing.tail, tail + 1, memory_order_release);
+    }
+    return NULL;
+}
+void captureFrame(const PongMatchSnapshot* view) { // Main thread: scale this frame into a record target and queue the previous one, never waits on the encoder
+    PONG_ZONE("capture frame");
+    int current = recordFrameIndex % 2, previous = 1 - current;
+    BeginTextureMode(recordTargets[current]);
+    DrawTexturePro(renderTarget.texture, (Rectangle){0, 0, (float)renderTarget.texture.width, -(float)renderTarget.texture.height},
+                   (Rectangle){0, 0, RECORD_WIDTH, RECORD_HEIGHT}, (Vector2){0, 0}, 0.0f, WHITE);
+    EndTextureMode();
+    recordSnapshots[current] = *view;     // The match this frame drew, not a newer tick published since
+    if (recordFrameIndex++ == 0) return;     // Nothing rendered a frame ago yet
+    unsigned int head = atomic_load_explicit(&recordRing.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&recordRing.tail, memory_order_acquire) == RECORD_RING_SLOTS) {
+        pendingDrops++;              // Encoder is behind: drop the frame rather than stall the game
+        droppedFrames++;
+        return;
+    }
+    RecordSlot* slot = &recordRing.slots[head % RECORD_RING_SLOTS];
+    Image frame = LoadImageFromTexture(recordTargets[previous].texture);
+    memcpy(slot->pixels, frame.data, RECORD_WIDTH * RECORD_HEIGHT * 4);
+    UnloadImage(frame);
+    slot->snapshot = recordSnapshots[previous];
+    slot->droppedBefore = pendingDrops;
+    pendingDrops = 0;
+    atomic_store_explicit(&recordRing.head, head + 1, memory_order_release);
+}
+void loadRenderTarget(float scale) {
+    if (scale < MIN_RENDER_SCALE) scale = MIN_RENDER_SCALE;
+    if (scale > 1.0f) scale = 1.0f;
+    if (renderTarget.id != 0) UnloadRenderTexture(renderTarget);
+    renderScale = scale;
+    renderTarget = LoadRenderTexture((int)(SCREEN_WIDTH * scale), (int)(SCREEN_HEIGHT * scale));
+    SetTextureFilter(renderTarget.texture, renderFilter);
+    TraceLog(LOG_INFO, "Internal render resolution: %dx%d", renderTarget.texture.width, renderTarget.texture.height);
+}
+void updateRenderScale() { // Drop resolution when frames overrun the budget, probe back up after a stable stretch
+    static float frameTimeSum = 0.0f;
+    static int frameCount = 0;
+    static float stableTime = 0.0f;
+    static float upscaleDelay = 2.0f;
+    frameTimeSum += GetFrameTime();
+    if (++frameCount < 30) return;
+    float avgFrameTime = frameTimeSum / frameCount;
+    frameTimeSum = 0.0f;
+    frameCount = 0;
+    if (avgFrameTime > frameBudgetMs / 1000.0f * 1.1f && renderScale > MIN_RENDER_SCALE) {
+        if (stableTime < upscaleDelay && upscaleDelay < 60.0f) upscaleDelay *= 2.0f;  // Last step up did not hold
+        stableTime = 0.0f;
+        loadRenderTarget(renderScale - RENDER_SCALE_STEP);
+    } else if (renderScale < 1.0f) {
+        stableTime += avgFrameTime * 30;
+        if (stableTime >= upscaleDelay) {
+            stableTime = 0.0f;
+            loadRenderTarget(renderScale + RENDER_SCALE_STEP);
+        }
+    }
+}
+void drawTelemetry() { // In window pixels after the upscale, so it stays legible at any render scale
+    char line[128];
+    snprintf(line, sizeof(line), "Quality %s%s  budget %.1f ms  work %.2f ms  %d FPS  scale %d%%", pongQualityTier(&quality)->name,
+             quality.fixed ? " (fixed)" : "", quality.budgetMs, quality.workMs, GetFPS(), (int)(renderScale * 100 + 0.5f));
+    DrawRectangle(0, 0, MeasureText(line, 20) + 20, 30, BLACK);
+    DrawText(line, 10, 5, 20, GREEN);
+}
+void beginFrame() { // Scene is drawn in SCREEN_WIDTH x SCREEN_HEIGHT units, the camera zoom maps it onto the target
+    clock_gettime(CLOCK_MONOTONIC, &frameWorkStart);
+    BeginTextureMode(renderTarget);
+    BeginMode2D((Camera2D){ .offset = {0, 0}, .target = {0, 0}, .rotation = 0.0f, .zoom = renderScale });
+}
+void endFrame(const PongMatchSnapshot* view) { // view: the match drawn this frame, NULL for the menu, which is not recorded
+    PongTraceZone zone = pongTraceBegin("upscale");
+    EndMode2D();
+    EndTextureMode();
+    if (recording && view) captureFrame(view);
     BeginDrawing();
-    ClearBackground((Color){20, 20, 50, 255});  // Dark blue background
-    const char* titleText = "Zain Allaudin_PING PONG";
-    DrawText(titleText, SCREEN_WIDTH/2 - MeasureText(titleText, 40)/2, 100, 40, WHITE);
-    DrawRectangle(SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2 - 60, 400, 60, Fade(WHITE, 0.3f));
-    DrawRectangle(SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2 + 20, 400, 60, Fade(WHITE, 0.3f));
-    const char* singlePlayerText = "1 - SINGLE PLAYER";
-    const char* multiPlayerText = "2 - TWO PLAYER";
-    DrawText(singlePlayerText, SCREEN_WIDTH/2 - MeasureText(singlePlayerText, 30)/2, SCREEN_HEIGHT/2 - 45, 30, WHITE);
-    DrawText(multiPlayerText, SCREEN_WIDTH/2 - MeasureText(multiPlayerText, 30)/2, SCREEN_HEIGHT/2 + 35, 30, WHITE);
-    const char* instructionText = "Press 1 or 2 to select game mode";
-    DrawText(instructionText, SCREEN_WIDTH/2 - MeasureText(instructionText, 20)/2, SCREEN_HEIGHT - 100, 20, GRAY);
+    ClearBackground(BLACK);
+    float windowScale = fminf((float)GetScreenWidth() / SCREEN_WIDTH, (float)GetScreenHeight() / SCREEN_HEIGHT);
+    Rectangle source = {0, 0, (float)renderTarget.texture.width, -(float)renderTarget.texture.height};  // Render textures are stored upside down
+    Rectangle dest = {(GetScreenWidth() - SCREEN_WIDTH * windowScale) / 2, (GetScreenHeight() - SCREEN_HEIGHT * windowScale) / 2,
+                      SCREEN_WIDTH * windowScale, SCREEN_HEIGHT * windowScale};
+    DrawTexturePro(renderTarget.texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+    if (showTelemetry) drawTelemetry();
+    pongTraceEnd(&zone);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);     // Before EndDrawing, which waits for the frame rate cap
+    double workMs = (now.tv_sec - frameWorkStart.tv_sec) * 1000.0 + (now.tv_nsec - frameWorkStart.tv_nsec) / 1e6;
+    FrameTimeStats* stats = &frameTimes[recording];
+    stats->sumMs += workMs;
+    if (workMs > stats->maxMs) stats->maxMs = workMs;
+    stats->count++;
+    zone = pongTraceBegin("present (swap and frame cap)");
     EndDrawing();
+    pongTraceEnd(&zone);
+    if (pongQualityFrame(&quality, workMs, GetFrameTime() * 1000.0f, !autoRenderScale || renderScale >= 1.0f)) {     // Resolution comes back first
+        TraceLog(LOG_INFO, "Quality tier: %s, frame work %.2f ms of %.1f ms", pongQualityTier(&quality)->name, quality.workMs, quality.budgetMs);
+    }
+    if (!firstFrameShown) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        printf("Time to first frame: %.1f ms\n", (now.tv_sec - startTime.tv_sec) * 1000.0 + (now.tv_nsec - startTime.tv_nsec) / 1e6);
+        firstFrameShown = true;
+    }
+    if (autoRenderScale && (quality.fixed || quality.tier == 0 || renderScale < 1.0f)) updateRenderScale();     // Effects go first
 }
 void initializeGame() {
-    gameState.leftPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
-    gameState.rightPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
-    gameState.ballPosition.x = SCREEN_WIDTH / 2;
-    gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-    float levelSpeedMultiplier = 1.0f + (gameState.level - 1) * 0.5f;
-    float initialSpeed = INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
-    gameState.ballVelocity.x = initialSpeed * (GetRandomValue(0, 1) ? 1 : -1);
-    gameState.ballVelocity.y = initialSpeed * 0.5f * (GetRandomValue(0, 1) ? 1 : -1);
-    gameState.leftScore = 0;
-    gameState.rightScore = 0;
-    gameState.gameOver = false;
+    pongInitMatch(&gameState.match, 1, matchSeed ? matchSeed : (uint64_t)time(NULL)); // Start at level 1
     gameState.gamePaused = false;
-    gameState.level = 1; // Start at level 1
     gameState.twoPlayerMode = false;  // Default to single player
     gameState.modeSelected = false;   // Mode not selected yet
-    pthread_mutex_init(&gameState.stateMutex, NULL);
+    resetCpu();
+    publishMatch();                   // Before the ball thread starts, so readers never see an empty match
 }
-void drawGame() {
-    BeginDrawing();
-    Color bgColor;
-    switch (gameState.level) {
-        case 1:
-            bgColor = (Color){20, 20, 50, 255};    // Dark blue
-            break;
-        case 2:
-            bgColor = (Color){20, 50, 20, 255};    // Dark green
-            break;
-        case 3:
-            bgColor = (Color){50, 20, 50, 255};    // Dark purple
-            break;
-        default:
-            bgColor = BLACK;
-    }
-    ClearBackground(bgColor);
-    pthread_mutex_lock(&gameState.stateMutex);
+void drawField(const PongMatchSnapshot* view) { // Table, paddles, ball, scores and level, between beginFrame and endFrame
+    PONG_ZONE("field");
+    const PongTheme* theme = pongTheme(view->match.level);     // Colors, trail and label, all worked out when the levels were loaded
+    const PongQualityTier* tier = pongQualityTier(&quality);
+    ClearBackground(theme->background);
     for (int y = 0; y < SCREEN_HEIGHT; y += 20) {     // Draw center line
         DrawRectangle(SCREEN_WIDTH/2 - 5, y, 10, 10, Fade(WHITE, 0.5f));
     }
-    Color paddleColor;
-    switch (gameState.level) {
-        case 1:
-            paddleColor = WHITE;               // White for level 1
-            break;
-        case 2:
-            paddleColor = LIME;                // Lime for level 2
-            break;
-        case 3:
-            paddleColor = RED;                 // Red for level 3
-            break;
-        default:
-            paddleColor = WHITE;
-    }
-    DrawRectangleRounded((Rectangle){0, gameState.leftPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT}, 0.3f, 8, paddleColor);
-    DrawRectangleRounded((Rectangle){SCREEN_WIDTH - PADDLE_WIDTH, gameState.rightPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT}, 0.3f, 8, paddleColor);
-    DrawText("P1", 10, gameState.leftPaddleY - 25, 20, WHITE);
-    if (gameState.twoPlayerMode) {
-        DrawText("P2", SCREEN_WIDTH - PADDLE_WIDTH - 10, gameState.rightPaddleY - 25, 20, WHITE);
+    Rectangle leftPaddle = {0, view->match.leftPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT};
+    Rectangle rightPaddle = {SCREEN_WIDTH - PADDLE_WIDTH, view->match.rightPaddleY, PADDLE_WIDTH, PADDLE_HEIGHT};
+    if (tier->paddleSegments > 0) {
+        DrawRectangleRounded(leftPaddle, 0.3f, tier->paddleSegments, theme->paddle);
+        DrawRectangleRounded(rightPaddle, 0.3f, tier->paddleSegments, theme->paddle);
     } else {
-        DrawText("CPU", SCREEN_WIDTH - PADDLE_WIDTH - 35, gameState.rightPaddleY - 25, 20, WHITE);
+        DrawRectangleRec(leftPaddle, theme->paddle);
+        DrawRectangleRec(rightPaddle, theme->paddle);
     }
-    Color ballColor;
-    switch (gameState.level) {
-        case 1:
-            ballColor = WHITE;                 // White for level 1
-            break;
-        case 2:
-            ballColor = YELLOW;                // Yellow for level 2
-            break;
-        case 3:
-            ballColor = (Color){255, 100, 100, 255};  // Light red for level 3
-            break;
-        default:
-            ballColor = WHITE;
+    DrawText("P1", 10, view->match.leftPaddleY - 25, 20, WHITE);
+    if (view->twoPlayerMode) {
+        DrawText("P2", SCREEN_WIDTH - PADDLE_WIDTH - 10, view->match.rightPaddleY - 25, 20, WHITE);
+    } else {
+        DrawText("CPU", SCREEN_WIDTH - PADDLE_WIDTH - 35, view->match.rightPaddleY - 25, 20, WHITE);
     }
-    int trailLength = 3 + gameState.level * 2;  // Level 1: 5, Level 2: 7, Level 3: 9
+    int trailLength = pongQualityTrail(&quality, theme->trailLength);     // The brightest circles, nearest the ball, are kept
     for (int i = 0; i < trailLength; i++) {
-        float alpha = 0.3f - (i * 0.03f);
-        if (alpha > 0) {
-            Vector2 trailPos = {
-                gameState.ballPosition.x - gameState.ballVelocity.x * (i * 1.5f),
-                gameState.ballPosition.y - gameState.ballVelocity.y * (i * 1.5f)
-            };
-            DrawCircle(trailPos.x, trailPos.y, BALL_RADIUS - i * 0.5f, Fade(ballColor, alpha));
-        }
+        Vector2 trailPos = {
+            view->match.ballPosition.x - view->match.ballVelocity.x * (i * 1.5f),
+            view->match.ballPosition.y - view->match.ballVelocity.y * (i * 1.5f)
+        };
+        DrawCircle(trailPos.x, trailPos.y, theme->trailRadius[i], theme->trail[i]);
     }
-    DrawCircle(gameState.ballPosition.x, gameState.ballPosition.y, BALL_RADIUS, ballColor);
+    DrawCircle(view->match.ballPosition.x, view->match.ballPosition.y, BALL_RADIUS, theme->ball);
     char scoreText[32];
-    sprintf(scoreText, "%d", gameState.leftScore);
+    sprintf(scoreText, "%d", view->match.leftScore);
     DrawText("P1", SCREEN_WIDTH/4 - 50, 30, 30, WHITE);
     DrawText(scoreText, SCREEN_WIDTH/4, 30, 60, WHITE);
-    sprintf(scoreText, "%d", gameState.rightScore);
-    if (gameState.twoPlayerMode) {
+    sprintf(scoreText, "%d", view->match.rightScore);
+    if (view->twoPlayerMode) {
         DrawText("P2", 3*SCREEN_WIDTH/4 - 70, 30, 30, WHITE);
     } else {
         DrawText("CPU", 3*SCREEN_WIDTH/4 - 90, 30, 30, WHITE);
     }
     DrawText(scoreText, 3*SCREEN_WIDTH/4 - 20, 30, 60, WHITE);
-    char levelText[32];
-    sprintf(levelText, "Level: %d", gameState.level);
-    Color levelColor;
-    switch (gameState.level) {
-        case 1:
-            levelColor = SKYBLUE;
-            break;
-        case 2:
-            levelColor = GREEN;
-            break;
-        case 3:
-            levelColor = MAGENTA;
-            break;
-        default:
-            levelColor = GOLD;
-    }
-    DrawRectangle(SCREEN_WIDTH/2 - MeasureText(levelText, 24)/2 - 10, 5, 
-                 MeasureText(levelText, 24) + 20, 30, Fade(BLACK, 0.7f));
-    DrawText(levelText, SCREEN_WIDTH/2 - MeasureText(levelText, 24)/2, 10, 24, levelColor);
-    if (gameState.gameOver) {
+    int labelWidth = MeasureText(theme->name, 24);
+    if (tier->alphaOverlays) DrawRectangle(SCREEN_WIDTH/2 - labelWidth/2 - 10, 5, labelWidth + 20, 30, Fade(BLACK, 0.7f));
+    DrawText(theme->name, SCREEN_WIDTH/2 - labelWidth/2, 10, 24, theme->label);
+}
+void drawGame(const PongMatchSnapshot* view) { // Main thread, from its copy of the published match: takes no lock
+    PONG_ZONE("drawGame");
+    beginFrame();
+    drawField(view);
+    PongTraceZone zone = pongTraceBegin("overlays");
+    Color backdrop = pongQualityTier(&quality)->alphaOverlays ? Fade(BLACK, 0.8f) : BLACK;
+    if (view->match.gameOver) {
         const char* gameOverText = "GAME OVER";
         const char* winnerText;
-        if (gameState.twoPlayerMode) {
-            winnerText = (gameState.leftScore > gameState.rightScore) ? "PLAYER 1 WINS!" : "PLAYER 2 WINS!";
+        if (view->twoPlayerMode) {
+            winnerText = (view->match.leftScore > view->match.rightScore) ? "PLAYER 1 WINS!" : "PLAYER 2 WINS!";
         } else {
-            winnerText = (gameState.leftScore > gameState.rightScore) ? "PLAYER WINS!" : "CPU WINS!";
+            winnerText = (view->match.leftScore > view->match.rightScore) ? "PLAYER WINS!" : "CPU WINS!";
         }
         const char* restartText = "Press R to Restart";
         const char* modeSelectText = "Press M to Mode Select";
-        DrawRectangle(0, SCREEN_HEIGHT/2 - 70, SCREEN_WIDTH, 140, Fade(BLACK, 0.8f));
+        DrawRectangle(0, SCREEN_HEIGHT/2 - 70, SCREEN_WIDTH, 140, backdrop);
         DrawText(gameOverText, SCREEN_WIDTH/2 - MeasureText(gameOverText, 40)/2, SCREEN_HEIGHT/2 - 60, 40, WHITE);
         DrawText(winnerText, SCREEN_WIDTH/2 - MeasureText(winnerText, 30)/2, SCREEN_HEIGHT/2 - 10, 30, YELLOW);
         DrawText(restartText, SCREEN_WIDTH/2 - MeasureText(restartText, 20)/2, SCREEN_HEIGHT/2 + 30, 20, GREEN);
         DrawText(modeSelectText, SCREEN_WIDTH/2 - MeasureText(modeSelectText, 20)/2, SCREEN_HEIGHT/2 + 60, 20, GREEN);
     }
-    if (gameState.gamePaused && !gameState.gameOver) {
+    if (view->gamePaused && !view->match.gameOver) {
         const char* pausedText = "GAME PAUSED";
         const char* resumeText = "Press P to Resume";
-        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, Fade(BLACK, 0.8f));
+        DrawRectangle(0, SCREEN_HEIGHT/2 - 60, SCREEN_WIDTH, 120, backdrop);
         DrawText(pausedText, SCREEN_WIDTH/2 - MeasureText(pausedText, 40)/2, SCREEN_HEIGHT/2 - 40, 40, WHITE);
         DrawText(resumeText, SCREEN_WIDTH/2 - MeasureText(resumeText, 20)/2, SCREEN_HEIGHT/2 + 20, 20, GREEN);
     }
-    if (!gameState.gameOver && !gameState.gamePaused) {
+    if (!view->match.gameOver && !view->gamePaused) {
         DrawText("W/S - P1 Move", 10, SCREEN_HEIGHT - 60, 20, Fade(WHITE, 0.7f));
         
-        if (gameState.twoPlayerMode) {
+        if (view->twoPlayerMode) {
             DrawText("UP/DOWN (Arrow Keys) - P2 Move", 10, SCREEN_HEIGHT - 30, 20, Fade(WHITE, 0.7f));
         } else {
             DrawText("P - Pause", 10, SCREEN_HEIGHT - 30, 20, Fade(WHITE, 0.7f));
@@ -312,94 +965,361 @@ void drawGame() {
         DrawText("L - Change Level", SCREEN_WIDTH - MeasureText("L - Change Level", 20) - 10, SCREEN_HEIGHT - 30, 20, Fade(WHITE, 0.7f));
         DrawText("P - Pause", SCREEN_WIDTH/2 - 40, SCREEN_HEIGHT - 30, 20, Fade(WHITE, 0.7f));
     }
-    pthread_mutex_unlock(&gameState.stateMutex);
-    EndDrawing();
+    pongTraceEnd(&zone);
+    endFrame(view);
+}
+void stepAttract() { // Main thread, one ball tick per frame: the same seeded scene on every run, whatever the frame rate
+    PONG_ZONE("attract step");
+    if (attractTicks == 0) {
+        pongInitMatch(&attract.match, 1, PONG_ATTRACT_SEED);
+        pongAiInit(&attractAis[0], true, PONG_ATTRACT_SEED ^ 0xA5A5A5A5A5A5A5A5ull);
+        pongAiInit(&attractAis[1], false, PONG_ATTRACT_SEED ^ 0x5A5A5A5A5A5A5A5Aull);
+    }
+    int level = 1 + (int)(attractTicks++ / PONG_ATTRACT_LEVEL_FRAMES % pongLevelCount);     // Shows every level's effects
+    if (attract.match.gameOver) pongInitMatch(&attract.match, level, pongRandomNext(&attractAis[0].rng));
+    attract.match.level = level;
+    float leftMove = pongAiTick(&attractAis[0], &attract.match);
+    attract.match.rightPaddleY += pongAiTick(&attractAis[1], &attract.match);
+    attract.match.leftPaddleY += leftMove;
+    pongClampPaddle(&attract.match.leftPaddleY);
+    pongClampPaddle(&attract.match.rightPaddleY);
+    pongStepBall(&attract.match);
+}
+void drawModeSelection() {
+    PONG_ZONE("drawModeSelection");
+    stepAttract();                   // Also when it is not drawn, so it carries on from the same point
+    beginFrame();
+    const PongQualityTier* tier = pongQualityTier(&quality);
+    if (tier->effects) drawField(&attract);
+    PongTraceZone zone = pongTraceBegin("menu");
+    if (tier->effects) DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.6f));     // Dim the attract match behind the menu
+    else ClearBackground(pongTheme(1)->background);
+    const char* titleText = "Zain Allaudin_PING PONG";
+    DrawText(titleText, SCREEN_WIDTH/2 - MeasureText(titleText, 40)/2, 100, 40, WHITE);
+    Color button = tier->alphaOverlays ? Fade(WHITE, 0.3f) : DARKGRAY;
+    DrawRectangle(SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2 - 60, 400, 60, button);
+    DrawRectangle(SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2 + 20, 400, 60, button);
+    const char* singlePlayerText = "1 - SINGLE PLAYER";
+    const char* multiPlayerText = "2 - TWO PLAYER";
+    DrawText(singlePlayerText, SCREEN_WIDTH/2 - MeasureText(singlePlayerText, 30)/2, SCREEN_HEIGHT/2 - 45, 30, WHITE);
+    DrawText(multiPlayerText, SCREEN_WIDTH/2 - MeasureText(multiPlayerText, 30)/2, SCREEN_HEIGHT/2 + 35, 30, WHITE);
+    if (pthread_mutex_trylock(&leaderboardMutex) == 0) {     // Keep the last copy rather than wait on the leaderboard thread
+        screenView = publishedView;
+        pthread_mutex_unlock(&leaderboardMutex);
+    }
+    if (screenView.loaded) {
+        char line[96];
+        sprintf(line, "%llu matches - vs CPU: %llu won, %llu lost", (unsigned long long)screenView.matches,
+                (unsigned long long)screenView.playerWins, (unsigned long long)screenView.cpuWins);
+        DrawText(line, SCREEN_WIDTH/2 - MeasureText(line, 20)/2, SCREEN_HEIGHT/2 + 110, 20, LIGHTGRAY);
+        for (int i = 0; i < screenView.topCount; i++) {
+            const MatchRecord* r = &screenView.top[i];
+            sprintf(line, "%d. Level %d  %d-%d  %u:%02u", i + 1, r->level, r->leftScore, r->rightScore,
+                    r->durationMs / 60000, r->durationMs / 1000 % 60);
+            DrawText(line, SCREEN_WIDTH/2 - 110, SCREEN_HEIGHT/2 + 140 + i * 24, 20, i == 0 ? GOLD : WHITE);
+        }
+    }
+    const char* instructionText = "Press 1 or 2 to select game mode";
+    DrawText(instructionText, SCREEN_WIDTH/2 - MeasureText(instructionText, 20)/2, SCREEN_HEIGHT - 100, 20, GRAY);
+    pongTraceEnd(&zone);
+    endFrame(NULL);
 }
-int main() {
+int main(int argc, char* argv[]) {
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    float startScale = 1.0f;
+    int qualityTier = -1;            // --quality, -1 = governed
+    for (int i = 1; i < argc; i++) { // --scale <0.25-1.0>, --auto-scale, --filter nearest|bilinear, --audio-buffer <frames>
+        if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) startScale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--auto-scale") == 0) autoRenderScale = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            renderFilter = (strcmp(argv[++i], "bilinear") == 0) ? TEXTURE_FILTER_BILINEAR : TEXTURE_FILTER_POINT;
+        }
+        else if (strcmp(argv[i], "--audio-buffer") == 0 && i + 1 < argc) {
+            char* end;
+            long frames = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || frames <= 0 || frames > 65536) {
+                printf("Bad --audio-buffer %s, need a frame count from 1 to 65536; keeping %d\n", argv[i], audioBufferFrames);
+            } else {
+                audioBufferFrames = (int)frames;
+            }
+        }
+        else if (strcmp(argv[i], "--pin-ball") == 0 && i + 1 < argc) ballCpu = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pin-main") == 0 && i + 1 < argc) mainCpu = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rt") == 0) realtimePhysics = true;
+        else if (strcmp(argv[i], "--mlock") == 0) lockMemory = true;
+        else if (strcmp(argv[i], "--jitter-report") == 0) jitterReport = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--analytics") == 0 && i + 1 < argc) analyticsPath = argv[++i];
+        else if (strcmp(argv[i], "--export-state") == 0) {     // Optional segment name, e.g. --export-state /table2
+            liveStateName = (i + 1 < argc && argv[i + 1][0] == '/') ? argv[++i] : PONG_SHM_NAME;
+            liveState = pongShmCreate(liveStateName);
+            if (!liveState) printf("Cannot create shared memory %s: %s\n", liveStateName, strerror(errno));
+        }
+        else if (strcmp(argv[i], "--bot-left") == 0 && i + 1 < argc) botPaths[BOT_SIDE_LEFT] = argv[++i];
+        else if (strcmp(argv[i], "--bot-right") == 0 && i + 1 < argc) botPaths[BOT_SIDE_RIGHT] = argv[++i];
+        else if (strcmp(argv[i], "--lockstep") == 0) lockstep = true;
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) matchSeed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshotPath = argv[++i];
+        else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) resumePath = argv[++i];
+        else if (strcmp(argv[i], "--resume-at") == 0 && i + 1 < argc) resumeFrame = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rematch-after") == 0 && i + 1 < argc) rematchAfterSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--perf-counters") == 0) perfCounters = true;
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];
+        else if (strcmp(argv[i], "--evdev") == 0) {     // Optional devices, e.g. --evdev /dev/input/event3,/dev/input/event7
+            evdevInput = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') evdevPaths = argv[++i];
+        }
+        else if (strcmp(argv[i], "--input-latency") == 0) inputLatency = true;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc) frameBudgetMs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {     // low|medium|high|full: pin the tier
+            qualityTier = pongQualityParse(argv[++i]);
+            if (qualityTier < 0) printf("Unknown quality %s, the tier follows the frame times\n", argv[i]);
+        }
+        else if (strcmp(argv[i], "--bench") == 0) {     // Optional frame count, e.g. --bench 3600
+            pongBenchStart(&bench, (i + 1 < argc && argv[i + 1][0] != '-') ? atol(argv[++i]) : PONG_BENCH_FRAMES);
+        }
+        else if (strcmp(argv[i], "--leaderboard") == 0 && i + 1 < argc) {
+            leaderboardPath = argv[++i];
+            if (strcmp(leaderboardPath, "none") == 0) leaderboardPath = NULL;
+        }
+    }
+    pongLoadLevels(levelsPath);     // Before any thread looks a level up; a bad file keeps the built-in levels
+    pongTraceOn = tracePath != NULL;     // Before any thread starts: they only read it
+    if (!(frameBudgetMs > 0)) frameBudgetMs = 1000.0f / 60.0f;
+    if (bench.target > 0 && qualityTier < 0) qualityTier = PONG_QUALITY_TIERS - 1;     // Bench numbers compare the same effects
+    pongQualityInit(&quality, frameBudgetMs, qualityTier);
+    if (bench.target > 0) leaderboardPath = NULL;     // The menu must look the same on every machine
+    for (int side = 0; side < 2; side++) {     // Before the window opens, so it is not left unresponsive while waiting
+        if (botPaths[side] && !botListen(&botLinks[side], botPaths[side], side)) {
+            printf("Cannot listen for a bot on %s: %s\n", botPaths[side], strerror(errno));
+        }
+    }
     srand(time(NULL));  // Initialize random seed
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Zain Allaudin_PING PONG");     // Initialize raylib
     InitAudioDevice();
-    SetTargetFPS(60);
+    SetTargetFPS(bench.target > 0 ? 0 : 60);     // Benchmark frames run unthrottled
+    loadRenderTarget(startScale);
+    SetAudioStreamBufferSizeDefault(audioBufferFrames);
+    synthStream = LoadAudioStream(AUDIO_SAMPLE_RATE, 32, 2);     // Stereo float, filled by synthCallback
+    SetAudioStreamCallback(synthStream, synthCallback);
+    PlayAudioStream(synthStream);
     initializeGame();
-    pthread_t ballThread, aiThread;
+    if (resumePath) {
+        PongMatchSnapshot snapshot;
+        struct timespec started;
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        if (pongSnapshotLoad(resumePath, PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, &snapshot, sizeof(snapshot), resumeFrame)) {
+            applySnapshot(&snapshot);
+            printf("Resumed %s (frame %ld) in %.1f us\n", resumePath, resumeFrame, microsecondsSince(&started));
+        } else {
+            printf("Cannot resume from %s: missing, another version, or no frame %ld\n", resumePath, resumeFrame);
+        }
+    }
+    if (botControls(BOT_SIDE_LEFT) && botControls(BOT_SIDE_RIGHT)) {     // Bot vs bot starts straight away
+        gameState.twoPlayerMode = true;
+        gameState.modeSelected = true;
+        clock_gettime(CLOCK_MONOTONIC, &matchStartTime);
+    }
+    tickCounters.cacheMissFd = tickCounters.switchFd = -1;
+    pthread_t encoderThread;
+    if (recordPath) {
+        char statesPath[1024];
+        snprintf(statesPath, sizeof(statesPath), "%s.states", recordPath);
+        statesFile = fopen(statesPath, "wb");
+        if (statesFile && pongVideoOpen(&clipWriter, recordPath, RECORD_WIDTH, RECORD_HEIGHT)) {
+            PongSnapshotHeader header = pongSnapshotHeader(PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, sizeof(PongMatchSnapshot));
+            fwrite(&header, sizeof(header), 1, statesFile);     // Each frame is a snapshot, so --resume-at can seek to it
+            for (int i = 0; i < 2; i++) recordTargets[i] = LoadRenderTexture(RECORD_WIDTH, RECORD_HEIGHT);
+            for (int i = 0; i < RECORD_RING_SLOTS; i++) recordRing.slots[i].pixels = malloc(RECORD_WIDTH * RECORD_HEIGHT * 4);
+            pthread_create(&encoderThread, NULL, encoderThreadFunc, NULL);
+            recording = true;
+        } else {
+            printf("Cannot record to %s\n", recordPath);
+            if (statesFile) fclose(statesFile);
+            recordPath = NULL;
+        }
+    }
+    pthread_t leaderboardThread;
+    if (leaderboardPath) pthread_create(&leaderboardThread, NULL, leaderboardThreadFunc, NULL);
+    pthread_t analyticsThread;
+    if (analyticsPath) {
+        FILE* analyticsFile = fopen(analyticsPath, "ab");     // Append-only: each session adds blocks
+        if (analyticsFile) {
+            fseek(analyticsFile, 0, SEEK_END);
+            if (ftell(analyticsFile) == 0) rallyWriteHeader(analyticsFile);
+            pthread_create(&analyticsThread, NULL, analyticsThreadFunc, analyticsFile);
+        } else {
+            printf("Cannot append analytics to %s\n", analyticsPath);
+            analyticsPath = NULL;
+        }
+    }
+    if (evdevInput && pongEvdevOpen(&evdev, evdevPaths) == 0) {     // Needs read access to /dev/input, usually the input group
+        if (evdevPaths || evdev.epollFd < 0) {
+            printf("evdev: no keyboard or gamepad could be opened, using raylib's keyboard input\n");
+            evdevInput = false;
+        } else {                     // Scanning: raylib's keyboard until a device turns up
+            printf("evdev: no keyboard or gamepad yet, using raylib's keyboard input until one is plugged in\n");
+        }
+    }
+    if (evdevInput && !pongEvdevStart(&evdev)) evdevInput = false;
+    pthread_t ballThread;
     pthread_create(&ballThread, NULL, ballThreadFunc, NULL);
-    pthread_create(&aiThread, NULL, aiThreadFunc, NULL);
-    Sound paddleHitSound = LoadSound("resources/paddle_hit.wav");
-    Sound wallHitSound = LoadSound("resources/wall_hit.wav");
-    Sound scoreSound = LoadSound("resources/score.wav");
+    pongConfigureThread(ballThread, "Ball", ballCpu, realtimePhysics);
+    pongConfigureThread(pthread_self(), "Main", mainCpu, false);
+    if (lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {     // After startup, so GL and audio buffers are resident
+        printf("Could not lock memory: %s\n", strerror(errno));
+    }
+    pongTraceThread("Main");
     while (!WindowShouldClose()) {     // Main game loop
-        if (!gameState.modeSelected) {
+        PONG_ZONE("frame");
+        PongTraceZone inputZone = pongTraceBegin("input");
+        sampleInput();
+        if (IsKeyPressed(KEY_F3)) showTelemetry = !showTelemetry;
+        if (!atomic_load_explicit(&gameState.modeSelected, memory_order_relaxed)) {
+            pongTraceEnd(&inputZone);
+            if (bench.target > 0) {
+                drawModeSelection();
+                if (!pongBenchFrame(&bench)) break;
+                continue;
+            }
             if (IsKeyPressed(KEY_ONE)) { // ASCII of 1=>49 (Decimal)
-                pthread_mutex_lock(&gameState.stateMutex);
-                gameState.twoPlayerMode = false;
-                gameState.modeSelected = true;
-                pthread_mutex_unlock(&gameState.stateMutex);
+                atomic_store_explicit(&gameState.twoPlayerMode, false, memory_order_release);
+                atomic_store_explicit(&gameState.modeSelected, true, memory_order_release);
+                clock_gettime(CLOCK_MONOTONIC, &matchStartTime);
             }
             else if (IsKeyPressed(KEY_TWO)) {
-                pthread_mutex_lock(&gameState.stateMutex);
-                gameState.twoPlayerMode = true;
-                gameState.modeSelected = true;
-                pthread_mutex_unlock(&gameState.stateMutex);
+                atomic_store_explicit(&gameState.twoPlayerMode, true, memory_order_release);
+                atomic_store_explicit(&gameState.modeSelected, true, memory_order_release);
+                clock_gettime(CLOCK_MONOTONIC, &matchStartTime);
             }
             drawModeSelection();
             continue;  // Skip the rest of the loop
         }
-        pthread_mutex_lock(&gameState.stateMutex);
-        if (IsKeyPressed(KEY_P)) {
-            gameState.gamePaused = !gameState.gamePaused;
-        }
-        if (IsKeyPressed(KEY_L) && !gameState.gameOver && !gameState.gamePaused) {
-            gameState.level = (gameState.level % 3) + 1;
-        }
-        if (IsKeyPressed(KEY_R) && gameState.gameOver) {
-            gameState.leftScore = 0;
-            gameState.rightScore = 0;
-            gameState.gameOver = false;
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-            float resetSpeed = INITIAL_BALL_SPEED * (1.0f + gameState.level * 0.2f);
-            gameState.ballVelocity.x = resetSpeed * (GetRandomValue(0, 1) ? 1 : -1);
-            gameState.ballVelocity.y = resetSpeed * 0.5f * (GetRandomValue(0, 1) ? 1 : -1);
-        }
-        if (IsKeyPressed(KEY_M) && gameState.gameOver) {
-            gameState.modeSelected = false;
-            gameState.gameOver = false;
-            gameState.leftScore = 0;
-            gameState.rightScore = 0;
-            gameState.leftPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
-            gameState.rightPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
-            gameState.ballPosition.x = SCREEN_WIDTH / 2;
-            gameState.ballPosition.y = SCREEN_HEIGHT / 2;
-        }
-        if (!gameState.gameOver && !gameState.gamePaused) {
-            if (IsKeyDown(KEY_W)) {
-                gameState.leftPaddleY -= PADDLE_SPEED;
-                if (gameState.leftPaddleY < 0) gameState.leftPaddleY = 0;
-            }
-            if (IsKeyDown(KEY_S)) {
-                gameState.leftPaddleY += PADDLE_SPEED;
-                if (gameState.leftPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) {
-                    gameState.leftPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
-                }
-            }
-            if (gameState.twoPlayerMode) {
-                if (IsKeyDown(KEY_UP)) {
-                    gameState.rightPaddleY -= PADDLE_SPEED;
-                    if (gameState.rightPaddleY < 0) gameState.rightPaddleY = 0;
-                }
-                
-                if (IsKeyDown(KEY_DOWN)) {
-                    gameState.rightPaddleY += PADDLE_SPEED;
-                    if (gameState.rightPaddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) {
-                        gameState.rightPaddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
-                    }
-                }
+        unsigned int commandsApplied;
+        PongMatchSnapshot view = readPublished(&commandsApplied);     // This frame's copy of the match; the flags are the main thread's own
+        view.gamePaused = atomic_load_explicit(&gameState.gamePaused, memory_order_relaxed);
+        view.twoPlayerMode = atomic_load_explicit(&gameState.twoPlayerMode, memory_order_relaxed);
+        bool matchReplaced = (int)(commandsApplied - awaitedCommand) >= 0;     // False while a restart or load is still queued
+        bool gameOver = view.match.gameOver && matchReplaced;     // Not the old game over meanwhile
+        if (IsKeyPressed(KEY_F5)) {     // Quick save: copy the published match, write in the background
+            struct timespec started;
+            clock_gettime(CLOCK_MONOTONIC, &started);
+            PongMatchSnapshot snapshot = readPublished(NULL);
+            pongSnapshotSaveAsync(snapshotPath, PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, &snapshot, sizeof(snapshot));
+            printf("Snapshot taken in %.1f us, writing %s\n", microsecondsSince(&started), snapshotPath);
+        }
+        if (IsKeyPressed(KEY_F8)) {
+            struct timespec started;
+            clock_gettime(CLOCK_MONOTONIC, &started);
+            PongMatchSnapshot snapshot;
+            if (pongSnapshotLoad(snapshotPath, PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, &snapshot, sizeof(snapshot), 0)) {
+                applySnapshot(&snapshot);
+                printf("Snapshot loaded in %.1f us\n", microsecondsSince(&started));
             }
         }
-        pthread_mutex_unlock(&gameState.stateMutex);
-        drawGame();
+        if (IsKeyPressed(KEY_F10) && tracePath) pongTraceWrite(tracePath);     // The zones so far; the threads keep tracing
+        if (IsKeyPressed(KEY_F9) && recordPath) {
+            recording = !recording;
+            recordFrameIndex = 0;     // Do not queue a stale frame from before the pause
+        }
+        if (IsKeyPressed(KEY_P)) {
+            view.gamePaused = !view.gamePaused;
+            atomic_store_explicit(&gameState.gamePaused, view.gamePaused, memory_order_release);
+        }
+        if (IsKeyPressed(KEY_L) && !gameOver && !view.gamePaused) {
+            postCommand((InputCommand){ .type = COMMAND_NEXT_LEVEL });
+        }
+        if (gameOver && !resultPosted) {     // Once per game-over screen, before anything can restart the match
+            clock_gettime(CLOCK_MONOTONIC, &gameOverTime);
+            if (leaderboardPath) postMatchResult(&view);
+            resultPosted = true;
+        }
+        if (gameOver && (IsKeyPressed(KEY_R) ||
+            (rematchAfterSeconds >= 0 && microsecondsSince(&gameOverTime) >= rematchAfterSeconds * 1e6))) {
+            restartMatch(false);
+        }
+        else if (IsKeyPressed(KEY_M) && gameOver) restartMatch(true);
+        pongTraceEnd(&inputZone);
+        drawGame(&view);
+        if (inputLatency) recordScreenLatency(view.ballTicks);
+    }
+    if (bench.target > 0) pongBenchReport(&bench, "PingPong.c");
+    pongQualityReport(&quality, "PingPong.c");
+    PongMatchSnapshot lastView = readPublished(NULL);
+    if (atomic_load(&gameState.modeSelected) && !lastView.match.gameOver) {     // Closed mid-match: keep it for --resume
+        if (pongSnapshotSave(snapshotPath, PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, &lastView, sizeof(lastView))) {
+            printf("Match saved to %s, continue it with --resume %s\n", snapshotPath, snapshotPath);
+        }
+    }
+    atomic_store(&workersDone, true);
+    for (int side = 0; side < 2; side++) {     // Wakes a lockstep ball thread waiting on a bot
+        if (botLinks[side].connected) shutdown(botLinks[side].fd, SHUT_RDWR);
+    }
+    pthread_join(ballThread, NULL);
+    if (evdevInput) {
+        pongEvdevStop(&evdev);
+        printf("evdev: %ld input events read, %ld paddle changes dropped\n", atomic_load(&evdev.events), atomic_load(&evdev.dropped));
+    }
+    if (inputLatency) {              // With raylib input a press is only timestamped when the frame samples it, so these read low
+        printf("Input latency, %s timestamps:\n", evdevInput ? "kernel (evdev)" : "frame sample (raylib)");
+        printLatency(&pressToTick, "paddle moved in the simulation");
+        printLatency(&pressToScreen, "paddle move on screen");
+    }
+    UnloadRenderTexture(renderTarget);
+    UnloadAudioStream(synthStream);
+    CloseAudioDevice();
+    if (latencyCount > 0) {
+        printf("Sound event-to-audio latency: avg %.2f ms, max %.2f ms over %ld events (%d-frame buffer)\n",
+               latencySumMs / latencyCount, latencyMaxMs, latencyCount, audioBufferFrames);
+    }
+    if (jitterReport) pongPrintJitterReport(&ballJitter, "Ball thread", BALL_TICK_US);
+    if (recordPath) {
+        atomic_store(&encoderDone, true);
+        pthread_join(encoderThread, NULL);
+        printf("Recorded %ld frames (%.1f MB) to %s, %ld dropped because the encoder fell behind\n",
+               clipWriter.frames, clipWriter.bytes / 1e6, recordPath, droppedFrames);
+        pongVideoClose(&clipWriter);
+        fclose(statesFile);
+        for (int i = 0; i < 2; i++) UnloadRenderTexture(recordTargets[i]);
+        for (int i = 0; i < RECORD_RING_SLOTS; i++) free(recordRing.slots[i].pixels);
+    }
+    botPrintStats(&botLinks[BOT_SIDE_LEFT], "Left");
+    botPrintStats(&botLinks[BOT_SIDE_RIGHT], "Right");
+    if (lockstep) printf("Ball ticks: %llu\n", (unsigned long long)ballTicks);
+    if (liveState) pongShmDestroy(liveState, liveStateName);     // Mapped readers keep the last state
+    if (tickCounters.ticks > 0) {
+        printf("Ball tick work: avg %.0f ns, %.1f cache misses and %.3f context switches per tick over %ld ticks\n",
+               tickCounters.workNs / tickCounters.ticks, (double)tickCounters.cacheMisses / tickCounters.ticks,
+               (double)tickCounters.contextSwitches / tickCounters.ticks, tickCounters.ticks);
+    }
+    if (restartStats.count > 0) {
+        printf("Restarts: %ld, reset avg %.1f us max %.1f us", restartStats.count, restartStats.resetSumUs / restartStats.count,
+               restartStats.resetMaxUs);
+        if (restartStats.firstTicks > 0) {
+            printf(", first tick after avg %.2f ms max %.2f ms", restartStats.firstTickSumMs / restartStats.firstTicks,
+                   restartStats.firstTickMaxMs);
+        }
+        printf("\n");
+    }
+    if (leaderboardPath) {
+        atomic_store(&leaderboardDone, true);
+        pthread_join(leaderboardThread, NULL);
+    }
+    if (analyticsPath) {
+        atomic_store(&analyticsDone, true);
+        pthread_join(analyticsThread, NULL);
+        long dropped = atomic_load(&rallyEvents.dropped);
+        if (dropped > 0) printf("Analytics: %ld rally events dropped because the flusher fell behind\n", dropped);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (frameTimes[i].count > 0) {
+            printf("Frame time with recording %s: avg %.2f ms, max %.2f ms over %ld frames\n", i ? "on" : "off",
+                   frameTimes[i].sumMs / frameTimes[i].count, frameTimes[i].maxMs, frameTimes[i].count);
+        }
     }
-    pthread_mutex_destroy(&gameState.stateMutex);     // Cleanup
+    if (tracePath) pongTraceWrite(tracePath);     // Every thread has been joined
     CloseWindow();
     return 0;
 }
\ No newline at end of file
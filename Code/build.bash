@@ -1 +1 @@
-gcc PingPong.c -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
\ No newline at end of file
+gcc PingPong.c -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
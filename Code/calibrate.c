@@ -0,0 +1,252 @@
+#include <stdio.h> // CPU difficulty calibration: gcc -O2 calibrate.c -o calibrate -lpthread -lm
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "pong_levels.h"
+#define MAX_TICKS 100000
+#define HISTORY 64                  // Past ball positions kept for the reference player's reaction delay
+#define MAX_CANDIDATES 4096
+typedef struct {
+    int reactionTicks;              // Sees the ball this many ticks late
+    float aimError;                 // Picks a random spot within this many pixels of the ball for each rally
+} PlayerModel;
+typedef struct {
+    PongLevel params;
+    double winRate;                 // Reference player's share of matches won
+} Candidate;
+PlayerModel player = { 12, 30.0f };     // About 200 ms, a typical keyboard reaction
+int calibratingLevel;
+int gamesPerCandidate = 100;
+uint64_t baseSeed = 1;
+Candidate candidates[MAX_CANDIDATES];
+int candidateCount;
+atomic_int nextCandidate;
+bool playMatch(const PongLevel* ai, uint64_t seed) { // true when the reference player (left paddle) wins
+    PongMatch match;
+    pongInitMatch(&match, calibratingLevel, seed);
+    PongRng playerRng = { seed ^ 0xA5A5A5A5A5A5A5A5ull };
+    PongAiController cpu;            // The game's controller, so its reaction delay is part of what gets calibrated
+    pongAiInit(&cpu, false, seed ^ 0x5A5A5A5A5A5A5A5Aull);
+    cpu.tuning = ai;
+    Vector2 history[HISTORY];
+    float aim = 0.0f;
+    for (long tick = 0; !match.gameOver && tick < MAX_TICKS; tick++) {
+        history[tick % HISTORY] = match.ballPosition;
+        Vector2 seen = history[(tick >= player.reactionTicks ? tick - player.reactionTicks : 0) % HISTORY];
+        float target = seen.y + aim - PADDLE_HEIGHT / 2;
+        if (match.leftPaddleY < target - PADDLE_SPEED) match.leftPaddleY += PADDLE_SPEED;     // Holding W/S
+        else if (match.leftPaddleY > target + PADDLE_SPEED) match.leftPaddleY -= PADDLE_SPEED;
+        match.rightPaddleY += pongAiTick(&cpu, &match);
+        pongClampPaddle(&match.leftPaddleY);
+        pongClampPaddle(&match.rightPaddleY);
+        int events = pongStepBall(&match);
+        if (events & (PONG_EVENT_RIGHT_PADDLE | PONG_EVENT_LEFT_SCORED | PONG_EVENT_RIGHT_SCORED)) {
+            aim = (pongRandomValue(&playerRng, -100, 100) / 100.0f) * player.aimError;
+        }
+    }
+    return match.leftScore > match.rightScore;
+}
+double measureWinRate(const PongLevel* ai) { // Same seeds for every candidate, so they are compared on equal games
+    int wins = 0;
+    for (int g = 0; g < gamesPerCandidate; g++) {
+        wins += playMatch(ai, baseSeed + g * 0x9E3779B97F4A7C15ull);
+    }
+    return (double)wins / gamesPerCandidate;
+}
+void* workerThread(void* arg) {
+    int index;
+    while ((index = atomic_fetch_add(&nextCandidate, 1)) < candidateCount) {
+        candidates[index].winRate = measureWinRate(&candidates[index].params);
+    }
+    return NULL;
+}
+void evaluateCandidates(int threadCount) {
+    pthread_t threads[256];
+    atomic_store(&nextCandidate, 0);
+    for (int i = 0; i < threadCount; i++) pthread_create(&threads[i], NULL, workerThread, NULL);
+    for (int i = 0; i < threadCount; i++) pthread_join(threads[i], NULL);
+}
+bool loadable(const PongLevel* p) { // What pongLoadLevels accepts
+    return p->serveSpeedMultiplier > 0 && INITIAL_BALL_SPEED * p->serveSpeedMultiplier <= MAX_BALL_SPEED &&
+           p->minBounceSpeed > 0 && p->minBounceSpeed <= MAX_BALL_SPEED && p->difficultyFactor > 0 && p->difficultyFactor <= 2 &&
+           p->errorRange >= 0 && p->errorRange <= SCREEN_HEIGHT && p->aiSpeed > 0 && p->aiSpeed * p->difficultyFactor <= PADDLE_HEIGHT / 2 &&
+           p->reactionTimeMs >= 0 && p->reactionTimeMs <= 2000;
+}
+void addGrid(const PongLevel* center, float factorStep, float errorStep, int reactionStep, int radius) {
+    candidateCount = 0;
+    for (int predicts = 0; predicts < 2; predicts++) {
+        for (int f = -radius; f <= radius; f++) {
+            for (int e = -radius; e <= radius; e++) {
+                for (int r = -radius; r <= radius; r++) {
+                    PongLevel params = *center;
+                    params.predictsBounce = predicts;
+                    params.difficultyFactor = center->difficultyFactor + f * factorStep;
+                    params.errorRange = center->errorRange + e * errorStep;
+                    params.reactionTimeMs = center->reactionTimeMs + r * reactionStep;
+                    if (params.difficultyFactor < 0.1f) continue;
+                    if (candidateCount < MAX_CANDIDATES && loadable(&params)) candidates[candidateCount++].params = params;
+                }
+            }
+        }
+    }
+}
+void addSpeedGrid(const PongLevel* center, float speedStep, float serveStep, float bounceStep, int radius) { // CPU paddle and ball speeds, the rest kept
+    candidateCount = 0;
+    for (int a = -radius; a <= radius; a++) {
+        for (int s = -radius; s <= radius; s++) {
+            for (int b = -radius; b <= radius; b++) {
+                PongLevel params = *center;
+                params.aiSpeed = center->aiSpeed + a * speedStep;
+                params.serveSpeedMultiplier = center->serveSpeedMultiplier + s * serveStep;
+                params.minBounceSpeed = center->minBounceSpeed + b * bounceStep;
+                if (candidateCount < MAX_CANDIDATES && loadable(&params)) candidates[candidateCount++].params = params;
+            }
+        }
+    }
+}
+double distance(const PongLevel* a, const PongLevel* b) { // Tie-break: stay close to the hand-tuned feel
+    return fabs(a->difficultyFactor - b->difficultyFactor) / 0.25 + fabs(a->errorRange - b->errorRange) / 25.0 +
+           abs(a->reactionTimeMs - b->reactionTimeMs) / 25.0 + (a->predictsBounce != b->predictsBounce) +
+           fabs(a->aiSpeed - b->aiSpeed) / 1.0 + fabs(a->serveSpeedMultiplier - b->serveSpeedMultiplier) / 0.2 +
+           fabs(a->minBounceSpeed - b->minBounceSpeed) / 1.5;
+}
+const Candidate* best(double target, const PongLevel* original) {
+    const Candidate* chosen = &candidates[0];
+    for (int i = 1; i < candidateCount; i++) {
+        double miss = fabs(candidates[i].winRate - target), chosenMiss = fabs(chosen->winRate - target);
+        if (miss < chosenMiss - 1e-9 || (miss < chosenMiss + 1e-9 && distance(&candidates[i].params, original) <
+                                                                      distance(&chosen->params, original))) {
+            chosen = &candidates[i];
+        }
+    }
+    return chosen;
+}
+unsigned int colorRgb(Color color) { // Inverse of pongRgb, for writing a levels file
+    return (unsigned int)color.r << 16 | (unsigned int)color.g << 8 | color.b;
+}
+int main(int argc, char* argv[]) {
+    const char* outputPath = NULL;
+    const char* levelsPath = NULL;      // --levels: calibrate a level file's table instead of the built-in one
+    char* targetList = NULL;
+    int threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--targets") == 0 && i + 1 < argc) targetList = argv[++i];     // Player win rate per level, e.g. 0.75,0.5,0.25
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) gamesPerCandidate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--reaction-ms") == 0 && i + 1 < argc) player.reactionTicks = atoi(argv[++i]) / AI_THINK_MS;
+        else if (strcmp(argv[i], "--aim-error") == 0 && i + 1 < argc) player.aimError = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) baseSeed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) outputPath = argv[++i];
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];
+        else {
+            printf("Usage: %s [--targets 0.75,0.5,0.25] [--games N] [--reaction-ms MS] [--aim-error PX]\n"
+                   "          [--seed S] [--threads N] [--levels file] [--output ai_levels.h|levels file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!pongLoadLevels(levelsPath)) return 1;
+    if (!outputPath) outputPath = levelsPath ? "calibrated_levels.txt" : "ai_levels.h";
+    double targets[PONG_MAX_LEVELS];
+    for (int l = 0; l < pongLevelCount; l++) {     // Default: player wins 75% at level 1 down to 25% at the top
+        targets[l] = (pongLevelCount == 1) ? 0.5 : 0.75 - 0.5 * l / (pongLevelCount - 1);
+    }
+    for (int l = 0; l < pongLevelCount && targetList; l++) {
+        targets[l] = atof(targetList);
+        targetList = strchr(targetList, ',');
+        if (targetList) targetList++;
+    }
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > 256) threadCount = 256;
+    if (player.reactionTicks >= HISTORY) player.reactionTicks = HISTORY - 1;
+    printf("Reference player: %d ms reaction, %.0f px aim error; %d games per candidate, %d threads\n",
+           player.reactionTicks * AI_THINK_MS, player.aimError, gamesPerCandidate, threadCount);
+    PongLevel calibrated[PONG_MAX_LEVELS];
+    double achieved[PONG_MAX_LEVELS];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long evaluated = 0;
+    for (int l = 0; l < pongLevelCount; l++) {
+        calibratingLevel = l + 1;
+        const PongLevel* original = &pongLevels[l];
+        printf("Level %d: current table gives the player %.1f%% (target %.1f%%)\n", l + 1,
+               100.0 * measureWinRate(original), 100.0 * targets[l]);
+        PongLevel center = *original;                // Coarse grid around the current values, then two finer passes
+        float factorStep = 0.15f, errorStep = 25.0f;
+        int reactionTicks = 2;                       // The controller rounds reactionTimeMs to whole ticks, so finer steps change nothing
+        const Candidate* chosen = NULL;
+        for (int pass = 0; pass < 3; pass++) {
+            addGrid(&center, factorStep, errorStep, reactionTicks * AI_THINK_MS, pass == 0 ? 3 : 1);
+            evaluateCandidates(threadCount);
+            evaluated += candidateCount;
+            chosen = best(targets[l], original);
+            center = chosen->params;
+            factorStep /= 2;
+            errorStep /= 2;
+            reactionTicks = reactionTicks / 2 > 0 ? reactionTicks / 2 : 1;
+        }
+        double samplingError = sqrt(targets[l] * (1 - targets[l]) / gamesPerCandidate);
+        if (samplingError < 1.0 / gamesPerCandidate) samplingError = 1.0 / gamesPerCandidate;
+        float speedStep = center.aiSpeed / 4, serveStep = 0.1f, bounceStep = 1.0f;
+        for (int pass = 0; pass < 2 && fabs(chosen->winRate - targets[l]) > 2 * samplingError; pass++) {
+            addSpeedGrid(&center, speedStep, serveStep, bounceStep, 2);     // The CPU knobs ran out; move the paddle and ball speeds too
+            evaluateCandidates(threadCount);
+            evaluated += candidateCount;
+            chosen = best(targets[l], original);
+            center = chosen->params;
+            speedStep /= 2;
+            serveStep /= 2;
+            bounceStep /= 2;
+        }
+        calibrated[l] = chosen->params;
+        achieved[l] = chosen->winRate;
+        printf("Level %d: difficulty %.3f, error %.1f px, reaction %d ms, %s, CPU speed %.3f, serve %.3f, bounce %.2f -> player wins %.1f%%\n",
+               l + 1, chosen->params.difficultyFactor, chosen->params.errorRange, chosen->params.reactionTimeMs,
+               chosen->params.predictsBounce ? "predicts bounce" : "follows ball", chosen->params.aiSpeed,
+               chosen->params.serveSpeedMultiplier, chosen->params.minBounceSpeed, 100.0 * chosen->winRate);
+        if (fabs(chosen->winRate - targets[l]) > 2 * samplingError) {
+            printf("Level %d: warning, %.1f%% misses the %.1f%% target by more than the sampling error (%.1f%% at %d games)\n",
+                   l + 1, 100.0 * chosen->winRate, 100.0 * targets[l], 200.0 * samplingError, gamesPerCandidate);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%ld candidates, %ld matches in %.1f s (%.0f matches/s)\n", evaluated, evaluated * gamesPerCandidate,
+           seconds, evaluated * gamesPerCandidate / seconds);
+    FILE* out = fopen(outputPath, "w");
+    if (!out) {
+        printf("Cannot write %s\n", outputPath);
+        return 1;
+    }
+    if (levelsPath) {     // Same format as the --levels file, with its speeds, colors and trails kept
+        fprintf(out, "# Generated by calibrate.c from %s. Load with --levels %s\n", levelsPath, outputPath);
+        fprintf(out, "# Reference player: %d ms reaction, %.0f px aim error, %d games per candidate, seed %llu\n",
+                player.reactionTicks * AI_THINK_MS, player.aimError, gamesPerCandidate, (unsigned long long)baseSeed);
+        fprintf(out, "#serve bounce predicts difficulty error cpuSpeed reactionMs background paddle ball   label  trail\n");
+        for (int l = 0; l < pongLevelCount; l++) {
+            const PongLevel* p = &calibrated[l];
+            const PongTheme* theme = &pongThemes[l];
+            fprintf(out, "%.3f %.3f %d %.3f %.1f %.3f %d %06X %06X %06X %06X %d   # Level %d: player wins %.1f%% (target %.1f%%)\n",
+                    p->serveSpeedMultiplier, p->minBounceSpeed, p->predictsBounce ? 1 : 0, p->difficultyFactor, p->errorRange,
+                    p->aiSpeed, p->reactionTimeMs, colorRgb(theme->background), colorRgb(theme->paddle), colorRgb(theme->ball), colorRgb(theme->label),
+                    theme->trailLength, l + 1, 100.0 * achieved[l], 100.0 * targets[l]);
+        }
+    } else {
+        fprintf(out, "// Generated by calibrate.c - do not edit. Build with -DPONG_LEVELS_FILE='\"%s\"'\n", outputPath);
+        fprintf(out, "// Reference player: %d ms reaction, %.0f px aim error, %d games per candidate, seed %llu\n",
+                player.reactionTicks * AI_THINK_MS, player.aimError, gamesPerCandidate, (unsigned long long)baseSeed);
+        fprintf(out, "static PongLevel pongLevels[PONG_MAX_LEVELS] = {\n");
+        for (int l = 0; l < pongLevelCount; l++) {
+            const PongLevel* p = &calibrated[l];
+            fprintf(out, "    { %.3ff, %.3ff, %s, %.3ff, %.1ff, %.3ff, %d },   // Level %d: player wins %.1f%% (target %.1f%%)\n",
+                    p->serveSpeedMultiplier, p->minBounceSpeed, p->predictsBounce ? "true" : "false", p->difficultyFactor,
+                    p->errorRange, p->aiSpeed, p->reactionTimeMs, l + 1, 100.0 * achieved[l], 100.0 * targets[l]);
+        }
+        fprintf(out, "};\n");
+    }
+    fclose(out);
+    printf("Level table written to %s\n", outputPath);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdio.h> // Fixed-point physics check and benchmark: gcc -O3 -march=native fixedbench.c -o fixedbench -lm
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pong_fixed.h"
+#define FNV_OFFSET 0xCBF29CE484222325ull
+#define FNV_PRIME 0x100000001B3ull
+typedef struct {
+    double seconds;
+    uint64_t checksum;
+} Run;
+double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) { // FNV-1a
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * FNV_PRIME;
+    return hash;
+}
+uint64_t hashFixed(uint64_t hash, const PongFixedMatch* match) { // Field by field, so struct padding stays out of it
+    int32_t fields[] = { match->leftPaddleY, match->rightPaddleY, match->ballX, match->ballY, match->velocityX, match->velocityY,
+                         match->leftScore, match->rightScore, match->gameOver, match->level };
+    hash = hashBytes(hash, fields, sizeof(fields));
+    return hashBytes(hash, &match->rng.state, sizeof(match->rng.state));
+}
+uint64_t hashFloat(uint64_t hash, const PongMatch* match) {
+    float fields[] = { match->leftPaddleY, match->rightPaddleY, match->ballPosition.x, match->ballPosition.y,
+                       match->ballVelocity.x, match->ballVelocity.y };
+    int scores[] = { match->leftScore, match->rightScore };
+    hash = hashBytes(hash, fields, sizeof(fields));
+    return hashBytes(hash, scores, sizeof(scores));
+}
+void trackFloat(float* paddleY, float ballY) { // Both paddles follow the ball at paddle speed, the tournament's tracker bot
+    float move = ballY - PADDLE_HEIGHT / 2 - *paddleY;
+    *paddleY += fmaxf(-PADDLE_SPEED, fminf(PADDLE_SPEED, move));
+    pongClampPaddle(paddleY);
+}
+int32_t trackFixed(int32_t paddleY, int32_t ballY) { // trackFloat in Q16.16
+    int32_t move = ballY - PONG_FIXED(PADDLE_HEIGHT / 2) - paddleY;
+    move = move < -PONG_FIXED(PADDLE_SPEED) ? -PONG_FIXED(PADDLE_SPEED) : move;
+    move = move > PONG_FIXED(PADDLE_SPEED) ? PONG_FIXED(PADDLE_SPEED) : move;
+    paddleY += move;
+    paddleY = paddleY < 0 ? 0 : paddleY;
+    return paddleY > PONG_FIXED(SCREEN_HEIGHT - PADDLE_HEIGHT) ? PONG_FIXED(SCREEN_HEIGHT - PADDLE_HEIGHT) : paddleY;
+}
+Run runFloat(int count, long ticks, int level, uint64_t seed) { // pong_sim.h, one match after the other like tournament.c
+    PongMatch* matches = malloc(count * sizeof(PongMatch));
+    for (int i = 0; i < count; i++) pongInitMatch(&matches[i], level, seed + i);
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        PongMatch* match = &matches[i];
+        for (long tick = 0; tick < ticks; tick++) {
+            trackFloat(&match->leftPaddleY, match->ballPosition.y);
+            trackFloat(&match->rightPaddleY, match->ballPosition.y);
+            pongStepBall(match);
+        }
+    }
+    Run run = { now() - start, FNV_OFFSET };
+    for (int i = 0; i < count; i++) run.checksum = hashFloat(run.checksum, &matches[i]);
+    free(matches);
+    return run;
+}
+Run runScalar(int count, long ticks, int level, uint64_t seed, PongFixedMatch* matches) {
+    for (int i = 0; i < count; i++) pongFixedInitMatch(&matches[i], level, seed + i);
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        PongFixedMatch* match = &matches[i];
+        for (long tick = 0; tick < ticks; tick++) {
+            match->leftPaddleY = trackFixed(match->leftPaddleY, match->ballY);
+            match->rightPaddleY = trackFixed(match->rightPaddleY, match->ballY);
+            pongFixedStepBall(match);
+        }
+    }
+    Run run = { now() - start, FNV_OFFSET };
+    for (int i = 0; i < count; i++) run.checksum = hashFixed(run.checksum, &matches[i]);
+    return run;
+}
+Run runBatch(int count, long ticks, int level, uint64_t seed, PongFixedBatch* batch) { // All matches advance together, a tick at a time
+    for (int i = 0; i < count; i++) {
+        pongFixedInitMatch(&batch->matches[i], level, seed + i);
+        pongFixedLoad(batch, i);
+    }
+    double start = now();
+    for (long tick = 0; tick < ticks; tick++) {
+        for (int i = 0; i < count; i++) {
+            batch->leftPaddleY[i] = trackFixed(batch->leftPaddleY[i], batch->ballY[i]);
+            batch->rightPaddleY[i] = trackFixed(batch->rightPaddleY[i], batch->ballY[i]);
+        }
+        pongFixedStepBatch(batch);
+    }
+    Run run = { now() - start, FNV_OFFSET };
+    for (int i = 0; i < count; i++) {
+        pongFixedSync(batch, i);
+        run.checksum = hashFixed(run.checksum, &batch->matches[i]);
+    }
+    return run;
+}
+void report(const char* name, Run run, long steps) {
+    printf("%-13s %8.1f M steps/s   %7.3f s   checksum %016llx\n", name, steps / run.seconds / 1e6, run.seconds,
+           (unsigned long long)run.checksum);
+}
+int main(int argc, char* argv[]) {
+    int count = 4096, level = 2;
+    long ticks = 20000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) ticks = atol(argv[++i]);
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) level = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else {
+            printf("Usage: %s [--matches n] [--ticks n] [--level n] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count < 1 || ticks < 1) {
+        printf("--matches and --ticks must be at least 1\n");
+        return 2;
+    }
+    PongFixedMatch* scalar = malloc(count * sizeof(PongFixedMatch));
+    PongFixedBatch batch;
+    if (!scalar || !pongFixedAllocBatch(&batch, count)) {
+        printf("Out of memory for %d matches\n", count);
+        return 2;
+    }
+    long steps = (long)count * ticks;
+    printf("%d matches x %ld ticks on level %d, seeds %llu..%llu\n", count, ticks, level, (unsigned long long)seed,
+           (unsigned long long)(seed + count - 1));
+    Run floatRun = runFloat(count, ticks, level, seed);
+    Run scalarRun = runScalar(count, ticks, level, seed, scalar);
+    Run batchRun = runBatch(count, ticks, level, seed, &batch);
+    report("float", floatRun, steps);
+    report("fixed scalar", scalarRun, steps);
+    report("fixed batch", batchRun, steps);
+    int mismatch = -1;
+    for (int i = 0; i < count && mismatch < 0; i++) {
+        if (hashFixed(FNV_OFFSET, &scalar[i]) != hashFixed(FNV_OFFSET, &batch.matches[i])) mismatch = i;
+    }
+    if (mismatch >= 0) printf("Scalar and batch differ first on seed %llu\n", (unsigned long long)(seed + mismatch));
+    else printf("Scalar and batch agree bit for bit\n");     // Across builds, compare the fixed checksums yourself
+    free(scalar);
+    pongFixedFreeBatch(&batch);
+    return mismatch >= 0 ? 1 : 0;
+}
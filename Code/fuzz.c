@@ -0,0 +1,274 @@
+#include <stdio.h> // Physics invariant fuzzer for pong_sim.h: gcc -O2 fuzz.c -o fuzz -lpthread -lm
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "pong_levels.h"
+#define TICKS_PER_CASE 10000
+#define MAX_WALL_STREAK 3           // Consecutive wall bounces before the ball counts as stuck on a wall
+enum {
+    INV_BOUNDS = 1,                 // Ball centre inside the field after every tick
+    INV_SPEED = 2,                  // Speed never above MAX_BALL_SPEED
+    INV_TUNNEL = 4,                 // Ball never passes through a paddle face without a hit
+    INV_SCORES = 8,                 // Scores only go up, by at most one per tick
+    INV_WALL = 16,                  // Ball does not bounce off a wall tick after tick
+    INV_COUNT = 5
+};
+const char* invariantNames[INV_COUNT] = {"bounds", "speed", "tunnel", "scores", "wall"};
+typedef struct {
+    uint64_t seed;
+    long tick;
+    PongMatch before;               // State just before the failing tick, for minimization
+    float leftMove, rightMove;
+} Failure;
+int checks = INV_BOUNDS | INV_SPEED | INV_TUNNEL | INV_SCORES | INV_WALL;
+atomic_long totalTicks;
+atomic_ulong nextSeed;
+atomic_int failedMask;              // Invariants that already have a recorded failure
+Failure failures[INV_COUNT];
+atomic_bool stop;
+void randomMatch(PongMatch* match, PongRng* rng) { // Any reachable-looking state, not just kick-offs
+    pongInitMatch(match, pongRandomValue(rng, 1, pongLevelCount), pongRandomNext(rng));
+    match->leftPaddleY = pongRandomValue(rng, 0, SCREEN_HEIGHT - PADDLE_HEIGHT);
+    match->rightPaddleY = pongRandomValue(rng, 0, SCREEN_HEIGHT - PADDLE_HEIGHT);
+    match->ballPosition.x = pongRandomValue(rng, 0, SCREEN_WIDTH * 100) / 100.0f;
+    match->ballPosition.y = pongRandomValue(rng, 0, SCREEN_HEIGHT * 100) / 100.0f;
+    float speed = pongRandomValue(rng, 0, (int)(MAX_BALL_SPEED * 1000)) / 1000.0f;
+    float angle = pongRandomValue(rng, 0, 62831) / 10000.0f;
+    match->ballVelocity.x = speed * cosf(angle);
+    match->ballVelocity.y = speed * sinf(angle);
+    match->leftScore = pongRandomValue(rng, 0, MAX_SCORE - 1);
+    match->rightScore = pongRandomValue(rng, 0, MAX_SCORE - 1);
+}
+float randomInput(PongRng* rng, float* held) { // Keys are held for a while, like a player would
+    if (pongRandomValue(rng, 0, 15) == 0) *held = (pongRandomValue(rng, 0, 2) - 1) * PADDLE_SPEED;
+    return *held;
+}
+bool crossesPaddle(const PongMatch* before, float faceX, float paddleY) { // Centre path crosses the face within the paddle
+    float vx = before->ballVelocity.x;
+    if (vx == 0.0f) return false;
+    float t = (faceX - before->ballPosition.x) / vx;
+    if (t <= 0.0f || t > 1.0f) return false;
+    float y = before->ballPosition.y + before->ballVelocity.y * t;
+    return y >= 0 && y <= SCREEN_HEIGHT && y >= paddleY && y <= paddleY + PADDLE_HEIGHT;
+}
+int violations(const PongMatch* before, const PongMatch* after, int events, int* wallStreak) {
+    int failed = 0;
+    if (after->ballPosition.x < 0 || after->ballPosition.x > SCREEN_WIDTH ||
+        after->ballPosition.y < 0 || after->ballPosition.y > SCREEN_HEIGHT) failed |= INV_BOUNDS;
+    if (pongSpeed(after->ballVelocity) > MAX_BALL_SPEED * 1.0001f) failed |= INV_SPEED;
+    if (before->ballPosition.x >= PADDLE_WIDTH + BALL_RADIUS &&
+        crossesPaddle(before, PADDLE_WIDTH + BALL_RADIUS, before->leftPaddleY) && !(events & PONG_EVENT_LEFT_PADDLE)) {
+        failed |= INV_TUNNEL;
+    }
+    if (before->ballPosition.x <= SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS &&
+        crossesPaddle(before, SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS, before->rightPaddleY) &&
+        !(events & PONG_EVENT_RIGHT_PADDLE)) {
+        failed |= INV_TUNNEL;
+    }
+    if (after->leftScore < before->leftScore || after->leftScore > before->leftScore + 1 ||
+        after->rightScore < before->rightScore || after->rightScore > before->rightScore + 1) failed |= INV_SCORES;
+    *wallStreak = (events & PONG_EVENT_WALL) ? *wallStreak + 1 : 0;
+    if (*wallStreak > MAX_WALL_STREAK) failed |= INV_WALL;
+    return failed & checks;
+}
+int stepChecked(PongMatch* match, float leftMove, float rightMove, int* wallStreak) {
+    PongMatch before = *match;
+    match->leftPaddleY += leftMove;
+    match->rightPaddleY += rightMove;
+    pongClampPaddle(&match->leftPaddleY);
+    pongClampPaddle(&match->rightPaddleY);
+    before.leftPaddleY = match->leftPaddleY;     // Paddles move before the ball, as in the game
+    before.rightPaddleY = match->rightPaddleY;
+    int events = pongStepBall(match);
+    return violations(&before, match, events, wallStreak);
+}
+long runCase(uint64_t seed, bool record) { // Returns ticks run
+    PongRng rng = { seed };
+    PongMatch match;
+    randomMatch(&match, &rng);
+    float leftHeld = 0.0f, rightHeld = 0.0f;
+    int wallStreak = 0;
+    long tick = 0;
+    for (; tick < TICKS_PER_CASE && !match.gameOver; tick++) {
+        PongMatch before = match;
+        float leftMove = randomInput(&rng, &leftHeld), rightMove = randomInput(&rng, &rightHeld);
+        int failed = stepChecked(&match, leftMove, rightMove, &wallStreak);
+        if (failed && record) {
+            for (int i = 0; i < INV_COUNT; i++) {
+                int bit = 1 << i;
+                if ((failed & bit) && !(atomic_fetch_or(&failedMask, bit) & bit)) {     // First failure of each kind wins
+                    failures[i] = (Failure){ seed, tick, before, leftMove, rightMove };
+                }
+            }
+        }
+    }
+    return tick;
+}
+void* workerThread(void* arg) {
+    long ticks = 0;
+    while (!atomic_load(&stop)) {
+        uint64_t seed = atomic_fetch_add(&nextSeed, 1);
+        ticks += runCase(seed, true);
+        if (ticks > 1000000) {
+            atomic_fetch_add(&totalTicks, ticks);
+            ticks = 0;
+        }
+    }
+    atomic_fetch_add(&totalTicks, ticks);
+    return NULL;
+}
+int minimize(const Failure* failure, int invariant, PongMatch* reduced, int* ticksNeeded) { // Shortest no-input repro
+    PongRng rng = { failure->seed };                 // Replay the case, keeping the last few states
+    PongMatch match, history[64];
+    randomMatch(&match, &rng);
+    float leftHeld = 0.0f, rightHeld = 0.0f;
+    int wallStreak = 0;
+    for (long tick = 0; tick <= failure->tick; tick++) {
+        history[tick % 64] = match;
+        float leftMove = randomInput(&rng, &leftHeld), rightMove = randomInput(&rng, &rightHeld);
+        stepChecked(&match, leftMove, rightMove, &wallStreak);
+    }
+    for (int back = 0; back < 64 && back <= failure->tick; back++) {     // Latest start state that still fails with paddles idle
+        PongMatch start = history[(failure->tick - back) % 64];
+        PongMatch replay = start;
+        int streak = 0;
+        for (int t = 0; t <= back; t++) {
+            if (stepChecked(&replay, 0.0f, 0.0f, &streak) & invariant) {
+                *reduced = start;
+                *ticksNeeded = t + 1;
+                return 1;
+            }
+        }
+    }
+    PongMatch start = failure->before;               // Fold the failing tick's paddle moves into the state itself
+    start.leftPaddleY += failure->leftMove;
+    start.rightPaddleY += failure->rightMove;
+    pongClampPaddle(&start.leftPaddleY);
+    pongClampPaddle(&start.rightPaddleY);
+    PongMatch replay = start;
+    int streak = 0;
+    if (stepChecked(&replay, 0.0f, 0.0f, &streak) & invariant) {
+        *reduced = start;
+        *ticksNeeded = 1;
+        return 1;
+    }
+    return 0;
+}
+void printState(const PongMatch* m) { // Hex floats, so the state round-trips bit for bit through --state
+    printf("--state %a,%a,%a,%a,%a,%a,%d,%d,%d,%llu", m->leftPaddleY, m->rightPaddleY, m->ballPosition.x,
+           m->ballPosition.y, m->ballVelocity.x, m->ballVelocity.y, m->leftScore, m->rightScore, m->level,
+           (unsigned long long)m->rng.state);
+}
+int parseState(const char* text, PongMatch* m) {
+    unsigned long long rngState;
+    pongInitMatch(m, 1, 0);
+    int n = sscanf(text, "%a,%a,%a,%a,%a,%a,%d,%d,%d,%llu", &m->leftPaddleY, &m->rightPaddleY, &m->ballPosition.x,
+                   &m->ballPosition.y, &m->ballVelocity.x, &m->ballVelocity.y, &m->leftScore, &m->rightScore,
+                   &m->level, &rngState);
+    m->rng.state = rngState;
+    return n == 10;
+}
+void traceState(long tick, const PongMatch* m, int failed) {
+    printf("tick %6ld  ball (%9.3f, %8.3f) vel (%8.3f, %8.3f) |v| %6.3f  paddles %6.1f %6.1f  score %d-%d",
+           tick, m->ballPosition.x, m->ballPosition.y, m->ballVelocity.x, m->ballVelocity.y,
+           pongSpeed(m->ballVelocity), m->leftPaddleY, m->rightPaddleY, m->leftScore, m->rightScore);
+    for (int i = 0; i < INV_COUNT; i++) {
+        if (failed & (1 << i)) printf("  FAIL %s", invariantNames[i]);
+    }
+    printf("\n");
+}
+int main(int argc, char* argv[]) {
+    double seconds = 10.0;
+    int threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = (uint64_t)time(NULL) << 20;
+    const char* replayCase = NULL;
+    const char* stateText = NULL;
+    const char* levelsPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {     // e.g. --check bounds,tunnel
+            checks = 0;
+            for (int k = 0; k < INV_COUNT; k++) {
+                if (strstr(argv[i + 1], invariantNames[k])) checks |= 1 << k;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayCase = argv[++i];     // Trace one generated case until it fails
+        else if (strcmp(argv[i], "--state") == 0 && i + 1 < argc) stateText = argv[++i];       // Replay a minimized state with idle paddles
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];     // Fuzz a level file's table; cases pick from its levels
+        else {
+            printf("Usage: %s [--seconds S] [--threads N] [--seed S] [--check bounds,speed,tunnel,scores,wall] [--levels file]\n"
+                   "       %s [--levels file] --replay <case seed> | --state <minimized state>\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (!pongLoadLevels(levelsPath)) return 2;
+    if (replayCase) {     // Trace one generated case until it fails
+        PongRng rng = { strtoull(replayCase, NULL, 0) };
+        PongMatch match;
+        randomMatch(&match, &rng);
+        float leftHeld = 0.0f, rightHeld = 0.0f;
+        int wallStreak = 0, failed = 0;
+        long tick = 0;
+        for (; tick < TICKS_PER_CASE && !match.gameOver && !failed; tick++) {
+            float leftMove = randomInput(&rng, &leftHeld), rightMove = randomInput(&rng, &rightHeld);     // Same order as runCase
+            failed = stepChecked(&match, leftMove, rightMove, &wallStreak);
+            if (failed || tick % 500 == 0) traceState(tick, &match, failed);
+        }
+        return failed ? 1 : 0;
+    }
+    if (stateText) {     // Replay a minimized state with idle paddles
+        PongMatch match;
+        if (!parseState(stateText, &match)) {
+            printf("Bad --state\n");
+            return 2;
+        }
+        int wallStreak = 0, failed = 0;
+        traceState(-1, &match, 0);
+        for (long tick = 0; tick < 64 && !failed; tick++) {
+            failed = stepChecked(&match, 0.0f, 0.0f, &wallStreak);
+            traceState(tick, &match, failed);
+        }
+        return failed ? 1 : 0;
+    }
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > 256) threadCount = 256;
+    atomic_store(&nextSeed, seed);
+    printf("Fuzzing for %.0f s on %d threads from case seed %llu\n", seconds, threadCount, (unsigned long long)seed);
+    pthread_t threads[256];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < threadCount; i++) pthread_create(&threads[i], NULL, workerThread, NULL);
+    usleep((useconds_t)(seconds * 1e6));
+    atomic_store(&stop, true);
+    for (int i = 0; i < threadCount; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long ticks = atomic_load(&totalTicks);
+    printf("%ld ticks, %llu cases in %.2f s: %.1f M ticks/s\n", ticks,
+           (unsigned long long)(atomic_load(&nextSeed) - seed), elapsed, ticks / elapsed / 1e6);
+    int failed = atomic_load(&failedMask);
+    char levelsFlag[300] = "";           // Replays need the same table
+    if (levelsPath) snprintf(levelsFlag, sizeof(levelsFlag), "--levels %s ", levelsPath);
+    for (int i = 0; i < INV_COUNT; i++) {
+        if (!(failed & (1 << i))) continue;
+        printf("\nFAIL %s: case seed %llu at tick %ld (replay with %s--replay %llu)\n", invariantNames[i],
+               (unsigned long long)failures[i].seed, failures[i].tick, levelsFlag, (unsigned long long)failures[i].seed);
+        PongMatch reduced;
+        int ticksNeeded;
+        if (minimize(&failures[i], 1 << i, &reduced, &ticksNeeded)) {
+            printf("  minimized: fails after %d tick(s) with idle paddles: %s", ticksNeeded, levelsFlag);
+            printState(&reduced);
+            printf("\n");
+        } else {
+            printf("  needs the recorded paddle input to fail\n");
+        }
+    }
+    if (!failed) printf("All invariants held\n");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#ifndef PONG_BENCH_H // --bench for the raylib builds: a fixed attract scene, then frame time percentiles, draw calls and CPU time
+#define PONG_BENCH_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#define PONG_BENCH_FRAMES 1800       // Default length: 600 frames on each level
+#define PONG_BENCH_WARMUP 60         // Played but not measured: window, font and shader setup land here
+#define PONG_ATTRACT_SEED 1981ull    // Same scene on every run and every machine
+#define PONG_ATTRACT_LEVEL_FRAMES 600     // The attract match moves to the next level this often
+typedef struct {
+    long target;                     // Measured frames, 0 when not benchmarking
+    long frames;                     // Frames shown so far, warm-up included
+    float* frameMs;
+    struct timespec lastFrame, cpuStart, wallStart;
+    long drawCallsAtStart;
+} PongBench;
+static long pongDrawCalls;           // raylib has no draw call counter, so every draw function call made by the build is counted
+#define ClearBackground(...) (pongDrawCalls++, ClearBackground(__VA_ARGS__))     // Include this header after raylib.h
+#define DrawRectangle(...) (pongDrawCalls++, DrawRectangle(__VA_ARGS__))
+#define DrawRectangleRec(...) (pongDrawCalls++, DrawRectangleRec(__VA_ARGS__))
+#define DrawRectangleRounded(...) (pongDrawCalls++, DrawRectangleRounded(__VA_ARGS__))
+#define DrawCircle(...) (pongDrawCalls++, DrawCircle(__VA_ARGS__))
+#define DrawText(...) (pongDrawCalls++, DrawText(__VA_ARGS__))
+#define DrawTexturePro(...) (pongDrawCalls++, DrawTexturePro(__VA_ARGS__))
+#pragma GCC poison DrawPixel DrawPixelV DrawLine DrawLineV DrawLineEx DrawLineStrip DrawLineBezier     // Not counted: wrap one above before using it
+#pragma GCC poison DrawCircleV DrawCircleSector DrawCircleSectorLines DrawCircleGradient DrawCircleLines DrawCircleLinesV
+#pragma GCC poison DrawEllipse DrawEllipseLines DrawRing DrawRingLines DrawTriangle DrawTriangleLines DrawTriangleFan DrawTriangleStrip
+#pragma GCC poison DrawRectangleV DrawRectanglePro DrawRectangleGradientV DrawRectangleGradientH DrawRectangleGradientEx
+#pragma GCC poison DrawRectangleLines DrawRectangleLinesEx DrawRectangleRoundedLines DrawPoly DrawPolyLines DrawPolyLinesEx
+#pragma GCC poison DrawTexture DrawTextureV DrawTextureEx DrawTextureRec DrawTextureNPatch
+#pragma GCC poison DrawTextEx DrawTextPro DrawTextCodepoint DrawTextCodepoints DrawFPS
+static inline double pongBenchMs(const struct timespec* from, const struct timespec* to) {
+    return (to->tv_sec - from->tv_sec) * 1000.0 + (to->tv_nsec - from->tv_nsec) / 1e6;
+}
+static inline void pongBenchStart(PongBench* bench, long frames) {
+    bench->target = frames;
+    bench->frames = 0;
+    bench->frameMs = malloc(frames * sizeof(float));
+}
+static inline bool pongBenchFrame(PongBench* bench) { // After EndDrawing; false once the measured frames are done
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long measured = bench->frames - PONG_BENCH_WARMUP;
+    if (measured == 0) {
+        bench->wallStart = now;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &bench->cpuStart);
+        bench->drawCallsAtStart = pongDrawCalls;
+    } else if (measured > 0) {
+        bench->frameMs[measured - 1] = (float)pongBenchMs(&bench->lastFrame, &now);
+    }
+    bench->lastFrame = now;
+    bench->frames++;
+    return measured < bench->target;
+}
+static inline int pongBenchCompare(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+static inline void pongBenchReport(PongBench* bench, const char* build) {
+    long count = bench->frames - PONG_BENCH_WARMUP - 1;
+    if (count <= 0) {
+        printf("Bench %s: closed after %ld frames, before any were measured\n", build, bench->frames);
+        free(bench->frameMs);
+        return;
+    }
+    struct timespec cpuEnd;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuEnd);
+    double wallMs = pongBenchMs(&bench->wallStart, &bench->lastFrame);
+    qsort(bench->frameMs, count, sizeof(float), pongBenchCompare);
+    printf("Bench %s: %ld frames in %.2f s (%.1f FPS), frame time p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           build, count, wallMs / 1000.0, count * 1000.0 / wallMs, bench->frameMs[count / 2], bench->frameMs[count * 90 / 100],
+           bench->frameMs[count * 99 / 100], bench->frameMs[count - 1]);
+    printf("Bench %s: %.1f draw calls and %.2f ms CPU (all threads) per frame\n", build,
+           (double)(pongDrawCalls - bench->drawCallsAtStart) / count, pongBenchMs(&bench->cpuStart, &cpuEnd) / count);
+    free(bench->frameMs);
+}
+#endif
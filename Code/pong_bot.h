@@ -0,0 +1,131 @@
+#ifndef PONG_BOT_H // External paddle controllers over a Unix domain socket (PingPong.c --bot-left/--bot-right, pongbot.c)
+#define PONG_BOT_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#define BOT_RTT_SLOTS 256                    // Send times kept by tick, a command older than this is not timed
+#define BOT_RTT_BIN_US 10                    // Round-trip histogram: 10 us bins up to 100 ms
+#define BOT_RTT_BINS 10000
+enum { BOT_SIDE_LEFT = 0, BOT_SIDE_RIGHT = 1 };
+enum { BOT_FLAG_PAUSED = 1, BOT_FLAG_GAME_OVER = 2, BOT_FLAG_LOCKSTEP = 4 };
+typedef struct {                     // Game to bot, once per ball tick, 32 bytes little-endian
+    uint32_t tick;
+    uint8_t side;                    // BOT_SIDE_*, the paddle this bot drives
+    uint8_t flags;                   // BOT_FLAG_*
+    uint8_t leftScore, rightScore;
+    float ballX, ballY;
+    float ballVelocityX, ballVelocityY;
+    float paddleY;                   // Top of the bot's paddle
+    float opponentPaddleY;
+} BotStateMessage;
+typedef struct {                     // Bot to game, 8 bytes
+    uint32_t tick;                   // The state message this answers
+    float move;                      // Paddle move per tick in pixels, clamped to +-PADDLE_SPEED, positive is down
+} BotCommand;
+typedef struct {
+    int fd;
+    int side;
+    bool connected;
+    unsigned char pending[sizeof(BotCommand)];   // Partial command read so far
+    int pendingBytes;
+    float move;                      // Latest command, applied every tick until the next one
+    uint32_t answeredTick;
+    bool answered;                   // answeredTick is valid
+    int64_t sentAtNs[BOT_RTT_SLOTS];
+    uint32_t sentTick[BOT_RTT_SLOTS];
+    long rttCounts[BOT_RTT_BINS + 1];
+    long rttTotal;
+    double rttSumUs, rttMaxUs;
+} BotLink;
+static inline int64_t botNowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+static inline bool botListen(BotLink* link, const char* path, int side) { // Blocks until a bot connects to path
+    memset(link, 0, sizeof(*link));
+    link->side = side;
+    link->fd = -1;
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    unlink(path);
+    if (server < 0 || bind(server, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(server, 1) != 0) {
+        if (server >= 0) close(server);
+        return false;
+    }
+    printf("Waiting for the %s bot on %s\n", side == BOT_SIDE_LEFT ? "left" : "right", path);
+    link->fd = accept(server, NULL, NULL);
+    close(server);
+    unlink(path);
+    link->connected = link->fd >= 0;
+    return link->connected;
+}
+static inline void botSendState(BotLink* link, const BotStateMessage* message) { // Never blocks; a bot that stops reading misses states
+    if (!link->connected) return;
+    int slot = message->tick % BOT_RTT_SLOTS;
+    link->sentTick[slot] = message->tick;
+    link->sentAtNs[slot] = botNowNs();
+    ssize_t sent = send(link->fd, message, sizeof(*message), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent == (ssize_t)sizeof(*message) || (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) return;     // Whole, or none of it
+    if (sent >= 0) shutdown(link->fd, SHUT_RDWR);     // Part of a state: the stream is out of step with the 32-byte framing for good
+    link->connected = false;         // Its paddle stops, as when the bot goes away
+    link->move = 0.0f;
+}
+static inline void botReceived(BotLink* link, const BotCommand* command) {
+    int slot = command->tick % BOT_RTT_SLOTS;
+    if (link->sentTick[slot] == command->tick && link->sentAtNs[slot] != 0) {
+        double rttUs = (botNowNs() - link->sentAtNs[slot]) / 1e3;
+        int bin = (int)(rttUs / BOT_RTT_BIN_US);
+        link->rttCounts[bin < BOT_RTT_BINS ? bin : BOT_RTT_BINS]++;
+        link->rttTotal++;
+        link->rttSumUs += rttUs;
+        if (rttUs > link->rttMaxUs) link->rttMaxUs = rttUs;
+        link->sentAtNs[slot] = 0;    // Only the first answer to a state is timed
+    }
+    link->move = command->move;
+    link->answeredTick = command->tick;
+    link->answered = true;
+}
+static inline bool botPoll(BotLink* link, int timeoutMs, bool waitForTick, uint32_t tick) { // Reads the commands that arrived; with waitForTick, waits (-1 = forever) for one answering tick
+    while (link->connected) {
+        if (waitForTick && link->answered && link->answeredTick >= tick) return true;
+        struct pollfd request = { .fd = link->fd, .events = POLLIN };
+        if (poll(&request, 1, waitForTick ? timeoutMs : 0) <= 0) return false;
+        ssize_t got = recv(link->fd, link->pending + link->pendingBytes, sizeof(BotCommand) - link->pendingBytes, MSG_DONTWAIT);
+        if (got == 0 || (got < 0 && errno != EAGAIN && errno != EINTR)) {
+            link->connected = false;     // Bot went away: its paddle stops
+            link->move = 0.0f;
+            return false;
+        }
+        if (got < 0) continue;
+        link->pendingBytes += got;
+        if (link->pendingBytes == sizeof(BotCommand)) {
+            BotCommand command;
+            memcpy(&command, link->pending, sizeof(command));
+            link->pendingBytes = 0;
+            botReceived(link, &command);
+        }
+    }
+    return false;
+}
+static inline void botPrintStats(const BotLink* link, const char* name) {
+    if (link->rttTotal == 0) return;
+    long seen = 0;
+    double p50 = -1, p99 = -1;
+    for (int i = 0; i <= BOT_RTT_BINS; i++) {
+        seen += link->rttCounts[i];
+        if (p50 < 0 && seen * 2 >= link->rttTotal) p50 = (i + 1) * BOT_RTT_BIN_US;
+        if (p99 < 0 && seen * 100 >= link->rttTotal * 99) p99 = (i + 1) * BOT_RTT_BIN_US;
+    }
+    printf("%s bot round trip: avg %.1f us, p50 <%.0f us, p99 <%.0f us, max %.1f us over %ld commands\n", name,
+           link->rttSumUs / link->rttTotal, p50, p99, link->rttMaxUs, link->rttTotal);
+}
+#endif
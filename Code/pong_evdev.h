@@ -0,0 +1,286 @@
+#ifndef PONG_EVDEV_H // Linux evdev paddle input: keyboards and gamepads read on their own thread, with kernel timestamps
+#define PONG_EVDEV_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#define PONG_EVDEV_MAX_DEVICES 16
+#define PONG_EVDEV_RING 256          // Power of two, direction changes waiting for the ball thread
+#define PONG_EVDEV_POLL_MS 1         // epoll_wait timeout: events wake the thread at once, this only bounds shutdown and rescans
+#define PONG_EVDEV_RESCAN_MS 1000    // Looks for new devices (hotplug, uinput) this often when no paths were given
+#define PONG_EVDEV_SCAN_NODES 64     // /dev/input/event0 to event63
+#define PONG_EVDEV_KEYBOARD -1       // PongEvdevDevice.side of a keyboard: W/S drive the left paddle, Up/Down the right
+typedef struct {
+    int64_t timeNs;                  // Kernel timestamp of the event, CLOCK_MONOTONIC
+    int8_t side;                     // 0 left, 1 right, like BOT_SIDE_*
+    int8_t direction;                // Held from timeNs on: -1 up, 0 none, +1 down
+} PongKeyEvent;
+typedef struct {
+    int fd;
+    int side;                        // Gamepads drive one paddle each, alternating; PONG_EVDEV_KEYBOARD for keyboards
+    int stickMin, stickMax;          // ABS_Y range, for analog sticks
+    int resyncing;                   // After SYN_DROPPED: events are ignored until SYN_REPORT, then state is re-read
+    char path[32];
+    char name[64];
+} PongEvdevDevice;
+typedef struct {
+    PongEvdevDevice devices[PONG_EVDEV_MAX_DEVICES];
+    int deviceCount;                 // Slots used so far; an unplugged device leaves its slot with fd -1 for the next one
+    atomic_int live;                 // Devices open now, 0 until one is plugged in when scanning
+    int gamepads;                    // Assigned so far, the next one gets side gamepads % 2
+    int epollFd;
+    bool rescan;                     // Scanning /dev/input, not a fixed list
+    uint64_t held[2][2];             // [side][0 up, 1 down]: a bit per source, see pongEvdevSource
+    int8_t direction[2];             // Last direction queued per side
+    PongKeyEvent ring[PONG_EVDEV_RING];
+    atomic_uint head;                // Written by the evdev thread only
+    atomic_uint tail;                // Written by the consumer only
+    atomic_long events, dropped;     // Input events read; direction changes lost to a full ring
+    atomic_bool stop;
+    pthread_t thread;
+} PongEvdev;
+enum { PONG_EVDEV_KEYS_OR_HAT, PONG_EVDEV_STICK, PONG_EVDEV_BUTTONS };     // A device's sources, so one cannot release another
+static inline uint64_t pongEvdevSource(int index, int kind) {
+    return 1ull << (kind * PONG_EVDEV_MAX_DEVICES + index);
+}
+static inline bool pongEvdevTestBit(const unsigned long* bits, int bit) {
+    return bits[bit / (8 * sizeof(long))] >> (bit % (8 * sizeof(long))) & 1;
+}
+static inline bool pongEvdevAdd(PongEvdev* input, const char* path, bool quiet) { // Opens path if it is a keyboard or gamepad
+    int index = input->deviceCount;
+    for (int i = 0; i < input->deviceCount; i++) {
+        if (input->devices[i].fd < 0) {
+            if (index == input->deviceCount) index = i;     // Reuse the first unplugged slot
+        } else if (strcmp(input->devices[i].path, path) == 0) {
+            return false;            // Open already; a node that was unplugged and came back is opened again
+        }
+    }
+    if (index == PONG_EVDEV_MAX_DEVICES) return false;
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        if (!quiet) printf("evdev: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    PongEvdevDevice* device = &input->devices[index];
+    memset(device, 0, sizeof(*device));
+    device->fd = fd;
+    snprintf(device->path, sizeof(device->path), "%s", path);
+    unsigned long keys[KEY_CNT / (8 * sizeof(long)) + 1] = {0}, axes[ABS_CNT / (8 * sizeof(long)) + 1] = {0};
+    bool isInputDevice = ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0;
+    ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(axes)), axes);
+    if (ioctl(fd, EVIOCGNAME(sizeof(device->name)), device->name) < 0) snprintf(device->name, sizeof(device->name), "%s", path);
+    bool keyboard = !isInputDevice ||     // A pipe or file of raw events given by path: read it as a keyboard
+                    (pongEvdevTestBit(keys, KEY_W) && pongEvdevTestBit(keys, KEY_S)) || pongEvdevTestBit(keys, KEY_UP);
+    bool gamepad = isInputDevice && (pongEvdevTestBit(keys, BTN_GAMEPAD) || pongEvdevTestBit(keys, BTN_DPAD_UP) ||
+                                     pongEvdevTestBit(axes, ABS_HAT0Y));
+    if (!keyboard && !gamepad) {
+        close(fd);
+        device->fd = -1;
+        if (!quiet) printf("evdev: %s (%s) has no paddle keys, skipped\n", path, device->name);
+        return false;
+    }
+    int clock = CLOCK_MONOTONIC;     // Kernel timestamps on the game's clock instead of wall time
+    if (isInputDevice && ioctl(fd, EVIOCSCLOCKID, &clock) < 0) printf("evdev: %s keeps wall-clock timestamps\n", path);
+    device->side = keyboard ? PONG_EVDEV_KEYBOARD : input->gamepads++ % 2;
+    struct input_absinfo stick;
+    if (gamepad && pongEvdevTestBit(axes, ABS_Y) && ioctl(fd, EVIOCGABS(ABS_Y), &stick) >= 0) {
+        device->stickMin = stick.minimum;
+        device->stickMax = stick.maximum;
+    }
+    struct epoll_event watch = { .events = EPOLLIN, .data.u32 = index };
+    if (epoll_ctl(input->epollFd, EPOLL_CTL_ADD, fd, &watch) < 0) {
+        close(fd);
+        device->fd = -1;
+        return false;
+    }
+    if (index == input->deviceCount) input->deviceCount++;
+    atomic_fetch_add(&input->live, 1);
+    printf("evdev: %s (%s) as %s\n", path, device->name,
+           keyboard ? "keyboard, W/S left and Up/Down right" : device->side == 0 ? "gamepad, left paddle" : "gamepad, right paddle");
+    return true;
+}
+static inline void pongEvdevScan(PongEvdev* input) {
+    char path[32];
+    for (int node = 0; node < PONG_EVDEV_SCAN_NODES; node++) {
+        snprintf(path, sizeof(path), "/dev/input/event%d", node);
+        if (access(path, R_OK) == 0) pongEvdevAdd(input, path, true);
+    }
+}
+static inline int pongEvdevOpen(PongEvdev* input, const char* paths) { // paths: comma-separated, NULL scans /dev/input; returns devices opened
+    memset(input, 0, sizeof(*input));
+    input->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (input->epollFd < 0) return 0;
+    input->rescan = paths == NULL;
+    if (!paths) {
+        pongEvdevScan(input);
+        return atomic_load(&input->live);
+    }
+    char list[512], *save = NULL;
+    snprintf(list, sizeof(list), "%s", paths);
+    for (char* path = strtok_r(list, ",", &save); path; path = strtok_r(NULL, ",", &save)) pongEvdevAdd(input, path, false);
+    return atomic_load(&input->live);
+}
+static inline void pongEvdevQueue(PongEvdev* input, int side, int64_t timeNs) { // Called after every source change on side
+    int8_t direction = (input->held[side][1] != 0) - (input->held[side][0] != 0);
+    if (direction == input->direction[side]) return;
+    unsigned int head = atomic_load_explicit(&input->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&input->tail, memory_order_acquire) == PONG_EVDEV_RING) {
+        atomic_fetch_add_explicit(&input->dropped, 1, memory_order_relaxed);
+        return;                      // Retried on the next event from this side
+    }
+    input->ring[head % PONG_EVDEV_RING] = (PongKeyEvent){ timeNs, (int8_t)side, direction };
+    atomic_store_explicit(&input->head, head + 1, memory_order_release);
+    input->direction[side] = direction;
+}
+static inline void pongEvdevHold(PongEvdev* input, int side, int down, uint64_t source, bool held) {
+    if (held) input->held[side][down] |= source;
+    else input->held[side][down] &= ~source;
+}
+static inline void pongEvdevAxis(PongEvdev* input, int side, uint64_t source, int value, int min, int max) { // Beyond half way counts as held
+    int center = (min + max) / 2, threshold = (max - min) / 4;
+    pongEvdevHold(input, side, 0, source, value < center - threshold);
+    pongEvdevHold(input, side, 1, source, value > center + threshold);
+}
+static inline void pongEvdevResync(PongEvdev* input, int index) { // The kernel dropped events: read the device's current state instead
+    PongEvdevDevice* device = &input->devices[index];
+    uint64_t source = pongEvdevSource(index, PONG_EVDEV_KEYS_OR_HAT);
+    unsigned long keys[KEY_CNT / (8 * sizeof(long)) + 1] = {0};
+    bool keysRead = ioctl(device->fd, EVIOCGKEY(sizeof(keys)), keys) >= 0;
+    if (device->side == PONG_EVDEV_KEYBOARD) {
+        if (!keysRead) return;
+        pongEvdevHold(input, 0, 0, source, pongEvdevTestBit(keys, KEY_W));
+        pongEvdevHold(input, 0, 1, source, pongEvdevTestBit(keys, KEY_S));
+        pongEvdevHold(input, 1, 0, source, pongEvdevTestBit(keys, KEY_UP));
+        pongEvdevHold(input, 1, 1, source, pongEvdevTestBit(keys, KEY_DOWN));
+        return;
+    }
+    struct input_absinfo axis;
+    if (ioctl(device->fd, EVIOCGABS(ABS_HAT0Y), &axis) >= 0) pongEvdevAxis(input, device->side, source, axis.value, -1, 1);
+    if (device->stickMax > device->stickMin && ioctl(device->fd, EVIOCGABS(ABS_Y), &axis) >= 0) {
+        pongEvdevAxis(input, device->side, pongEvdevSource(index, PONG_EVDEV_STICK), axis.value, device->stickMin, device->stickMax);
+    }
+    if (keysRead) {
+        pongEvdevHold(input, device->side, 0, pongEvdevSource(index, PONG_EVDEV_BUTTONS), pongEvdevTestBit(keys, BTN_DPAD_UP));
+        pongEvdevHold(input, device->side, 1, pongEvdevSource(index, PONG_EVDEV_BUTTONS), pongEvdevTestBit(keys, BTN_DPAD_DOWN));
+    }
+}
+static inline void pongEvdevHandle(PongEvdev* input, int index, const struct input_event* event) {
+    PongEvdevDevice* device = &input->devices[index];
+    int64_t timeNs = (int64_t)event->input_event_sec * 1000000000 + (int64_t)event->input_event_usec * 1000;
+    if (event->type == EV_SYN) {
+        if (event->code == SYN_DROPPED) device->resyncing = 1;
+        else if (event->code == SYN_REPORT && device->resyncing) {
+            device->resyncing = 0;
+            pongEvdevResync(input, index);
+            pongEvdevQueue(input, 0, timeNs);
+            pongEvdevQueue(input, 1, timeNs);
+        }
+        return;
+    }
+    if (device->resyncing) return;
+    uint64_t source = pongEvdevSource(index, PONG_EVDEV_KEYS_OR_HAT);
+    int side = device->side;
+    if (event->type == EV_KEY && event->value != 2) {     // 2 is autorepeat, the key is still held
+        bool held = event->value != 0;
+        if (side == PONG_EVDEV_KEYBOARD) {
+            switch (event->code) {
+                case KEY_W: side = 0; pongEvdevHold(input, 0, 0, source, held); break;
+                case KEY_S: side = 0; pongEvdevHold(input, 0, 1, source, held); break;
+                case KEY_UP: side = 1; pongEvdevHold(input, 1, 0, source, held); break;
+                case KEY_DOWN: side = 1; pongEvdevHold(input, 1, 1, source, held); break;
+                default: return;
+            }
+        } else if (event->code == BTN_DPAD_UP || event->code == BTN_DPAD_DOWN) {
+            pongEvdevHold(input, side, event->code == BTN_DPAD_DOWN, pongEvdevSource(index, PONG_EVDEV_BUTTONS), held);
+        } else {
+            return;
+        }
+    } else if (event->type == EV_ABS && side != PONG_EVDEV_KEYBOARD && event->code == ABS_HAT0Y) {
+        pongEvdevAxis(input, side, source, event->value, -1, 1);
+    } else if (event->type == EV_ABS && side != PONG_EVDEV_KEYBOARD && event->code == ABS_Y && device->stickMax > device->stickMin) {
+        pongEvdevAxis(input, side, pongEvdevSource(index, PONG_EVDEV_STICK), event->value, device->stickMin, device->stickMax);
+    } else {
+        return;
+    }
+    pongEvdevQueue(input, side, timeNs);
+}
+static inline void pongEvdevRemove(PongEvdev* input, int index) { // Unplugged: its keys count as released, the slot is free for the next device
+    PongEvdevDevice* device = &input->devices[index];
+    epoll_ctl(input->epollFd, EPOLL_CTL_DEL, device->fd, NULL);
+    close(device->fd);
+    device->fd = -1;
+    atomic_fetch_sub(&input->live, 1);
+    printf("evdev: %s (%s) removed\n", device->path, device->name);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t sources = pongEvdevSource(index, PONG_EVDEV_KEYS_OR_HAT) | pongEvdevSource(index, PONG_EVDEV_STICK) |
+                       pongEvdevSource(index, PONG_EVDEV_BUTTONS);
+    for (int side = 0; side < 2; side++) {
+        input->held[side][0] &= ~sources;
+        input->held[side][1] &= ~sources;
+        pongEvdevQueue(input, side, (int64_t)now.tv_sec * 1000000000 + now.tv_nsec);
+    }
+}
+static inline void* pongEvdevThread(void* arg) {
+    PongEvdev* input = arg;
+    struct input_event events[64];
+    struct timespec lastScan;
+    clock_gettime(CLOCK_MONOTONIC, &lastScan);
+    while (!atomic_load_explicit(&input->stop, memory_order_relaxed)) {
+        struct epoll_event ready[PONG_EVDEV_MAX_DEVICES];
+        int count = epoll_wait(input->epollFd, ready, PONG_EVDEV_MAX_DEVICES, PONG_EVDEV_POLL_MS);
+        for (int i = 0; i < count; i++) {
+            int index = ready[i].data.u32;
+            PongEvdevDevice* device = &input->devices[index];
+            if (device->fd < 0) continue;
+            ssize_t bytes;
+            while ((bytes = read(device->fd, events, sizeof(events))) > 0) {
+                for (size_t e = 0; e < bytes / sizeof(struct input_event); e++) pongEvdevHandle(input, index, &events[e]);
+                atomic_fetch_add_explicit(&input->events, bytes / sizeof(struct input_event), memory_order_relaxed);
+            }
+            if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR) || (ready[i].events & (EPOLLHUP | EPOLLERR))) {
+                pongEvdevRemove(input, index);
+            }
+        }
+        if (input->rescan) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if ((now.tv_sec - lastScan.tv_sec) * 1000 + (now.tv_nsec - lastScan.tv_nsec) / 1000000 >= PONG_EVDEV_RESCAN_MS) {
+                pongEvdevScan(input);
+                lastScan = now;
+            }
+        }
+    }
+    return NULL;
+}
+static inline bool pongEvdevStart(PongEvdev* input) {
+    return pthread_create(&input->thread, NULL, pongEvdevThread, input) == 0;
+}
+static inline void pongEvdevStop(PongEvdev* input) {
+    atomic_store(&input->stop, true);
+    pthread_join(input->thread, NULL);
+    for (int i = 0; i < input->deviceCount; i++) {
+        if (input->devices[i].fd >= 0) close(input->devices[i].fd);
+    }
+    close(input->epollFd);
+}
+static inline bool pongEvdevPeek(PongEvdev* input, PongKeyEvent* event) { // Consumer: the oldest queued change, left in the ring
+    unsigned int tail = atomic_load_explicit(&input->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&input->head, memory_order_acquire)) return false;
+    *event = input->ring[tail % PONG_EVDEV_RING];
+    return true;
+}
+static inline void pongEvdevPop(PongEvdev* input) {
+    atomic_store_explicit(&input->tail, atomic_load_explicit(&input->tail, memory_order_relaxed) + 1, memory_order_release);
+}
+#endif
@@ -0,0 +1,272 @@
+#ifndef PONG_FIXED_H // pong_sim.h's ball rules in Q16.16 integers: the same match on every compiler, flag set and CPU
+#define PONG_FIXED_H
+#include <stdlib.h>
+#include <string.h>
+#include "pong_sim.h"
+#define PONG_FIXED_ONE 65536         // 1.0 in Q16.16; positions in pixels, velocities in pixels per tick
+#define PONG_FIXED(x) ((int32_t)((x) * PONG_FIXED_ONE))     // Compile-time constants that are exact in Q16.16
+#define PONG_FIXED_ANGLE_STEPS 256   // Bounce angle resolution across the paddle, 0.4 px of paddle per step
+#define PONG_FIXED_BOUNCE_GAIN 68813 // 1.05, pongBounceSpeed's speed-up per hit
+#define PONG_FIXED_HALF_SPEED 32768  // 0.5, pongServe's vertical share
+static const int32_t pongFixedCos[PONG_FIXED_ANGLE_STEPS + 1] = {     // cos((i / 256 - 0.5) * PI/3) in Q16.16
+    56756, 56889, 57022, 57154, 57284, 57414, 57543, 57671, 57798, 57923, 58048, 58172,
+    58295, 58417, 58538, 58658, 58777, 58896, 59013, 59129, 59244, 59358, 59471, 59583,
+    59694, 59805, 59914, 60022, 60129, 60235, 60340, 60444, 60547, 60649, 60751, 60851,
+    60950, 61048, 61145, 61241, 61336, 61429, 61522, 61614, 61705, 61795, 61884, 61971,
+    62058, 62144, 62228, 62312, 62394, 62476, 62556, 62636, 62714, 62791, 62868, 62943,
+    63017, 63090, 63162, 63233, 63303, 63372, 63440, 63506, 63572, 63637, 63700, 63763,
+    63824, 63884, 63944, 64002, 64059, 64115, 64170, 64224, 64277, 64329, 64379, 64429,
+    64477, 64525, 64571, 64616, 64661, 64704, 64746, 64787, 64827, 64865, 64903, 64940,
+    64975, 65010, 65043, 65075, 65107, 65137, 65166, 65194, 65220, 65246, 65271, 65294,
+    65317, 65338, 65358, 65378, 65396, 65413, 65429, 65443, 65457, 65470, 65481, 65492,
+    65501, 65509, 65516, 65522, 65527, 65531, 65534, 65535, 65536, 65535, 65534, 65531,
+    65527, 65522, 65516, 65509, 65501, 65492, 65481, 65470, 65457, 65443, 65429, 65413,
+    65396, 65378, 65358, 65338, 65317, 65294, 65271, 65246, 65220, 65194, 65166, 65137,
+    65107, 65075, 65043, 65010, 64975, 64940, 64903, 64865, 64827, 64787, 64746, 64704,
+    64661, 64616, 64571, 64525, 64477, 64429, 64379, 64329, 64277, 64224, 64170, 64115,
+    64059, 64002, 63944, 63884, 63824, 63763, 63700, 63637, 63572, 63506, 63440, 63372,
+    63303, 63233, 63162, 63090, 63017, 62943, 62868, 62791, 62714, 62636, 62556, 62476,
+    62394, 62312, 62228, 62144, 62058, 61971, 61884, 61795, 61705, 61614, 61522, 61429,
+    61336, 61241, 61145, 61048, 60950, 60851, 60751, 60649, 60547, 60444, 60340, 60235,
+    60129, 60022, 59914, 59805, 59694, 59583, 59471, 59358, 59244, 59129, 59013, 58896,
+    58777, 58658, 58538, 58417, 58295, 58172, 58048, 57923, 57798, 57671, 57543, 57414,
+    57284, 57154, 57022, 56889, 56756
+};
+static const int32_t pongFixedSin[PONG_FIXED_ANGLE_STEPS + 1] = {     // sin of the same angles
+    -32768, -32536, -32303, -32069, -31835, -31600, -31365, -31130, -30893, -30657, -30420, -30182,
+    -29944, -29705, -29466, -29226, -28986, -28745, -28504, -28262, -28020, -27778, -27535, -27291,
+    -27047, -26803, -26558, -26313, -26067, -25821, -25574, -25327, -25080, -24832, -24583, -24335,
+    -24086, -23836, -23586, -23336, -23085, -22834, -22582, -22331, -22078, -21826, -21573, -21320,
+    -21066, -20812, -20557, -20303, -20048, -19792, -19537, -19280, -19024, -18767, -18510, -18253,
+    -17995, -17738, -17479, -17221, -16962, -16703, -16444, -16184, -15924, -15664, -15403, -15143,
+    -14882, -14620, -14359, -14097, -13835, -13573, -13311, -13048, -12785, -12522, -12259, -11996,
+    -11732, -11468, -11204, -10940, -10676, -10411, -10146, -9881, -9616, -9351, -9085, -8820,
+    -8554, -8288, -8022, -7756, -7490, -7224, -6957, -6690, -6424, -6157, -5890, -5623,
+    -5356, -5088, -4821, -4554, -4286, -4019, -3751, -3483, -3216, -2948, -2680, -2412,
+    -2144, -1876, -1608, -1340, -1072, -804, -536, -268, 0, 268, 536, 804,
+    1072, 1340, 1608, 1876, 2144, 2412, 2680, 2948, 3216, 3483, 3751, 4019,
+    4286, 4554, 4821, 5088, 5356, 5623, 5890, 6157, 6424, 6690, 6957, 7224,
+    7490, 7756, 8022, 8288, 8554, 8820, 9085, 9351, 9616, 9881, 10146, 10411,
+    10676, 10940, 11204, 11468, 11732, 11996, 12259, 12522, 12785, 13048, 13311, 13573,
+    13835, 14097, 14359, 14620, 14882, 15143, 15403, 15664, 15924, 16184, 16444, 16703,
+    16962, 17221, 17479, 17738, 17995, 18253, 18510, 18767, 19024, 19280, 19537, 19792,
+    20048, 20303, 20557, 20812, 21066, 21320, 21573, 21826, 22078, 22331, 22582, 22834,
+    23085, 23336, 23586, 23836, 24086, 24335, 24583, 24832, 25080, 25327, 25574, 25821,
+    26067, 26313, 26558, 26803, 27047, 27291, 27535, 27778, 28020, 28262, 28504, 28745,
+    28986, 29226, 29466, 29705, 29944, 30182, 30420, 30657, 30893, 31130, 31365, 31600,
+    31835, 32069, 32303, 32536, 32768
+};
+typedef struct {                     // PongMatch with Q16.16 ball and paddles; scores, level and rng are the same
+    int32_t leftPaddleY;
+    int32_t rightPaddleY;
+    int32_t ballX, ballY;
+    int32_t velocityX, velocityY;
+    int leftScore;
+    int rightScore;
+    bool gameOver;
+    int level;
+    PongRng rng;
+} PongFixedMatch;
+typedef struct {                     // Structure of arrays for pongFixedStepBatch; the rarely touched fields stay in matches[]
+    int count;
+    int32_t* ballX;
+    int32_t* ballY;
+    int32_t* velocityX;
+    int32_t* velocityY;
+    int32_t* leftPaddleY;
+    int32_t* rightPaddleY;
+    int32_t* slow;                   // Lanes near a paddle or a goal line this tick
+    PongFixedMatch* matches;         // Scores, level and rng; ball and paddle fields are only current after pongFixedSync
+} PongFixedBatch;
+static inline int32_t pongFixedMul(int32_t a, int32_t b) { // Floors like the shift on every compiler this builds with (gcc, clang)
+    return (int32_t)(((int64_t)a * b) >> 16);
+}
+static inline int32_t pongFixedFromFloat(float value) { // Level table entries: x 65536 is exact, lroundf rounds the same everywhere
+    return (int32_t)lroundf(value * PONG_FIXED_ONE);
+}
+static inline float pongFixedToFloat(int32_t value) {
+    return value / (float)PONG_FIXED_ONE;
+}
+static inline uint32_t pongFixedSqrt(uint64_t value) { // Integer square root, bit by bit
+    uint64_t root = 0, bit = 1ull << 62;
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+static inline int32_t pongFixedSpeed(int32_t velocityX, int32_t velocityY) { // Q16.16 in, Q16.16 out: sqrt of a Q32.32 sum
+    return (int32_t)pongFixedSqrt((uint64_t)((int64_t)velocityX * velocityX + (int64_t)velocityY * velocityY));
+}
+static inline void pongFixedServe(PongFixedMatch* match) { // pongServe: same random draws in the same order
+    match->ballX = PONG_FIXED(SCREEN_WIDTH / 2);
+    match->ballY = PONG_FIXED(SCREEN_HEIGHT / 2);
+    int32_t initialSpeed = pongFixedFromFloat(pongLevel(match->level)->minBounceSpeed);
+    match->velocityX = pongRandomValue(&match->rng, 0, 1) ? initialSpeed : -initialSpeed;
+    int32_t vertical = pongFixedMul(initialSpeed, PONG_FIXED_HALF_SPEED);
+    match->velocityY = pongRandomValue(&match->rng, 0, 1) ? vertical : -vertical;
+}
+static inline void pongFixedInitMatch(PongFixedMatch* match, int level, uint64_t seed) {
+    match->rng.state = seed;
+    match->leftPaddleY = PONG_FIXED((SCREEN_HEIGHT - PADDLE_HEIGHT) / 2);
+    match->rightPaddleY = PONG_FIXED((SCREEN_HEIGHT - PADDLE_HEIGHT) / 2);
+    match->leftScore = 0;
+    match->rightScore = 0;
+    match->gameOver = false;
+    match->level = level;
+    pongFixedServe(match);
+}
+static inline void pongFixedResetBall(PongFixedMatch* match, int direction) { // pongResetBall
+    match->ballX = PONG_FIXED(SCREEN_WIDTH / 2);
+    match->ballY = PONG_FIXED(SCREEN_HEIGHT / 2);
+    int32_t serveSpeed = pongFixedMul(PONG_FIXED(INITIAL_BALL_SPEED), pongFixedFromFloat(pongLevel(match->level)->serveSpeedMultiplier));
+    match->velocityX = direction * serveSpeed;
+    int sign = pongRandomValue(&match->rng, 0, 1) ? 1 : -1;
+    int32_t share = (int32_t)(((int64_t)(60 + pongRandomValue(&match->rng, 0, 40)) << 16) / 100);     // 0.6 to 1.0
+    match->velocityY = sign * pongFixedMul(serveSpeed, share);
+}
+static inline int32_t pongFixedBounceSpeed(const PongFixedMatch* match) { // pongBounceSpeed
+    int32_t speed = pongFixedSpeed(match->velocityX, match->velocityY);
+    int32_t floor = pongFixedFromFloat(pongLevel(match->level)->minBounceSpeed);
+    speed = pongFixedMul(speed > floor ? speed : floor, PONG_FIXED_BOUNCE_GAIN);
+    return speed < PONG_FIXED(MAX_BALL_SPEED) ? speed : PONG_FIXED(MAX_BALL_SPEED);
+}
+static inline int pongFixedAngleStep(int32_t ballY, int32_t paddleY) { // Hit position on the paddle, 0 (top) to PONG_FIXED_ANGLE_STEPS
+    return (int)(((int64_t)(ballY - paddleY) * PONG_FIXED_ANGLE_STEPS) / PONG_FIXED(PADDLE_HEIGHT));
+}
+static inline void pongFixedMove(PongFixedMatch* match, int* events) { // First half of a tick: move, bounce off the walls
+    match->ballX += match->velocityX;
+    match->ballY += match->velocityY;
+    if (match->ballY <= 0 || match->ballY >= PONG_FIXED(SCREEN_HEIGHT)) {
+        match->velocityY = -match->velocityY;
+        *events |= PONG_EVENT_WALL;
+        if (match->ballY < 0) match->ballY = 0;
+        if (match->ballY > PONG_FIXED(SCREEN_HEIGHT)) match->ballY = PONG_FIXED(SCREEN_HEIGHT);
+    }
+}
+static inline bool pongFixedNearEdge(int32_t ballX) { // Whether pongFixedCollide can do anything this tick
+    return ballX - PONG_FIXED(BALL_RADIUS) <= PONG_FIXED(PADDLE_WIDTH) ||
+           ballX + PONG_FIXED(BALL_RADIUS) >= PONG_FIXED(SCREEN_WIDTH - PADDLE_WIDTH);
+}
+static inline void pongFixedCollide(PongFixedMatch* match, int* events) { // Second half: paddles, then points, as in pongStepBall
+    if (match->ballX - PONG_FIXED(BALL_RADIUS) <= PONG_FIXED(PADDLE_WIDTH) &&
+        match->ballY >= match->leftPaddleY &&
+        match->ballY <= match->leftPaddleY + PONG_FIXED(PADDLE_HEIGHT)) {
+        int step = pongFixedAngleStep(match->ballY, match->leftPaddleY);
+        int32_t newSpeed = pongFixedBounceSpeed(match);
+        match->velocityX = abs(pongFixedMul(newSpeed, pongFixedCos[step]));
+        match->velocityY = pongFixedMul(newSpeed, pongFixedSin[step]);
+        match->ballX = PONG_FIXED(PADDLE_WIDTH + BALL_RADIUS + 1);
+        *events |= PONG_EVENT_LEFT_PADDLE;
+    }
+    if (match->ballX + PONG_FIXED(BALL_RADIUS) >= PONG_FIXED(SCREEN_WIDTH - PADDLE_WIDTH) &&
+        match->ballY >= match->rightPaddleY &&
+        match->ballY <= match->rightPaddleY + PONG_FIXED(PADDLE_HEIGHT)) {
+        int step = pongFixedAngleStep(match->ballY, match->rightPaddleY);
+        int32_t newSpeed = pongFixedBounceSpeed(match);
+        match->velocityX = -abs(pongFixedMul(newSpeed, pongFixedCos[step]));
+        match->velocityY = pongFixedMul(newSpeed, pongFixedSin[step]);
+        match->ballX = PONG_FIXED(SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1);
+        *events |= PONG_EVENT_RIGHT_PADDLE;
+    }
+    if (match->ballX < 0) {
+        match->rightScore++;
+        *events |= PONG_EVENT_RIGHT_SCORED;
+        pongFixedResetBall(match, 1);
+        if (match->rightScore >= MAX_SCORE) match->gameOver = true;
+    }
+    if (match->ballX > PONG_FIXED(SCREEN_WIDTH)) {
+        match->leftScore++;
+        *events |= PONG_EVENT_LEFT_SCORED;
+        pongFixedResetBall(match, -1);
+        if (match->leftScore >= MAX_SCORE) match->gameOver = true;
+    }
+}
+static inline int pongFixedStepBall(PongFixedMatch* match) { // One tick, returns PONG_EVENT_* bits like pongStepBall
+    int events = 0;
+    pongFixedMove(match, &events);
+    if (pongFixedNearEdge(match->ballX)) pongFixedCollide(match, &events);
+    return events;
+}
+static inline void pongFixedClampPaddle(int32_t* paddleY) { // pongClampPaddle
+    if (*paddleY < 0) *paddleY = 0;
+    if (*paddleY > PONG_FIXED(SCREEN_HEIGHT - PADDLE_HEIGHT)) *paddleY = PONG_FIXED(SCREEN_HEIGHT - PADDLE_HEIGHT);
+}
+static inline void pongFixedToMatch(const PongFixedMatch* fixed, PongMatch* match) { // For drawing and snapshots
+    match->leftPaddleY = pongFixedToFloat(fixed->leftPaddleY);
+    match->rightPaddleY = pongFixedToFloat(fixed->rightPaddleY);
+    match->ballPosition = (Vector2){ pongFixedToFloat(fixed->ballX), pongFixedToFloat(fixed->ballY) };
+    match->ballVelocity = (Vector2){ pongFixedToFloat(fixed->velocityX), pongFixedToFloat(fixed->velocityY) };
+    match->leftScore = fixed->leftScore;
+    match->rightScore = fixed->rightScore;
+    match->gameOver = fixed->gameOver;
+    match->level = fixed->level;
+    match->rng = fixed->rng;
+}
+static inline bool pongFixedAllocBatch(PongFixedBatch* batch, int count) {
+    int32_t** lanes[] = { &batch->ballX, &batch->ballY, &batch->velocityX, &batch->velocityY,
+                          &batch->leftPaddleY, &batch->rightPaddleY, &batch->slow };
+    batch->count = count;
+    bool ok = (batch->matches = calloc(count, sizeof(PongFixedMatch))) != NULL;
+    for (int i = 0; i < (int)(sizeof(lanes) / sizeof(lanes[0])); i++) {
+        ok = (*lanes[i] = aligned_alloc(64, ((count * sizeof(int32_t) + 63) / 64) * 64)) != NULL && ok;
+    }
+    return ok;
+}
+static inline void pongFixedFreeBatch(PongFixedBatch* batch) {
+    free(batch->ballX); free(batch->ballY); free(batch->velocityX); free(batch->velocityY);
+    free(batch->leftPaddleY); free(batch->rightPaddleY); free(batch->slow); free(batch->matches);
+}
+static inline void pongFixedLoad(PongFixedBatch* batch, int i) { // matches[i] into the lanes
+    const PongFixedMatch* match = &batch->matches[i];
+    batch->ballX[i] = match->ballX;
+    batch->ballY[i] = match->ballY;
+    batch->velocityX[i] = match->velocityX;
+    batch->velocityY[i] = match->velocityY;
+    batch->leftPaddleY[i] = match->leftPaddleY;
+    batch->rightPaddleY[i] = match->rightPaddleY;
+}
+static inline void pongFixedSync(PongFixedBatch* batch, int i) { // The lanes back into matches[i]
+    PongFixedMatch* match = &batch->matches[i];
+    match->ballX = batch->ballX[i];
+    match->ballY = batch->ballY[i];
+    match->velocityX = batch->velocityX[i];
+    match->velocityY = batch->velocityY[i];
+    match->leftPaddleY = batch->leftPaddleY[i];
+    match->rightPaddleY = batch->rightPaddleY[i];
+}
+static inline int pongFixedMoveLanes(int count, int32_t* restrict ballX, int32_t* restrict ballY, const int32_t* restrict velocityX,
+                                     int32_t* restrict velocityY, int32_t* restrict slow) { // pongFixedMove and pongFixedNearEdge without branches, so -O3 vectorizes it
+    int slowCount = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t x = ballX[i] + velocityX[i], y = ballY[i] + velocityY[i];
+        int32_t wall = -(int32_t)((y <= 0) | (y >= PONG_FIXED(SCREEN_HEIGHT)));     // All ones on a bounce
+        velocityY[i] = (velocityY[i] ^ wall) - wall;
+        y = y < 0 ? 0 : y;                         // Inside the field the clamps change nothing, so they need no wall test
+        y = y > PONG_FIXED(SCREEN_HEIGHT) ? PONG_FIXED(SCREEN_HEIGHT) : y;
+        ballX[i] = x;
+        ballY[i] = y;
+        slow[i] = (x - PONG_FIXED(BALL_RADIUS) <= PONG_FIXED(PADDLE_WIDTH)) |
+                  (x + PONG_FIXED(BALL_RADIUS) >= PONG_FIXED(SCREEN_WIDTH - PADDLE_WIDTH));
+        slowCount += slow[i];
+    }
+    return slowCount;
+}
+static inline void pongFixedStepBatch(PongFixedBatch* batch) { // pongFixedStepBall on every lane, bit for bit
+    int slowCount = pongFixedMoveLanes(batch->count, batch->ballX, batch->ballY, batch->velocityX, batch->velocityY, batch->slow);
+    for (int i = 0; slowCount > 0 && i < batch->count; i++) {     // A few lanes per tick: the scalar collision code
+        if (!batch->slow[i]) continue;
+        int events = 0;
+        pongFixedSync(batch, i);
+        pongFixedCollide(&batch->matches[i], &events);
+        pongFixedLoad(batch, i);
+        slowCount--;
+    }
+}
+#endif
@@ -0,0 +1,27 @@
+#ifndef PONG_GLYPHS_H // 3x5 score digits shared by the software and GPU renderers (rerender.c, tables.c)
+#define PONG_GLYPHS_H
+static const char* const pongDigitGlyphs[10] = {     // One row per 3 bits, high bit is the left column
+    "\7\5\5\5\7", "\2\6\2\2\7", "\7\1\7\4\7", "\7\1\7\1\7", "\5\5\7\1\1",
+    "\7\4\7\1\7", "\7\4\7\5\7", "\7\1\1\1\1", "\7\5\7\5\7", "\7\5\7\1\7"
+};
+typedef struct {
+    unsigned char column, row, length;      // Horizontal run of lit cells
+} PongGlyphRun;
+typedef struct {
+    PongGlyphRun runs[10];           // At most two runs per row
+    int count;
+} PongGlyph;
+static inline PongGlyph pongGlyph(int digit) { // Lit cells merged row by row: one rectangle per run instead of one per cell
+    PongGlyph glyph = { .count = 0 };
+    for (int row = 0; row < 5; row++) {
+        for (int column = 0; column < 3; column++) {
+            if (!(pongDigitGlyphs[digit][row] & (4 >> column))) continue;
+            int length = 1;
+            while (column + length < 3 && (pongDigitGlyphs[digit][row] & (4 >> (column + length)))) length++;
+            glyph.runs[glyph.count++] = (PongGlyphRun){ column, row, length };
+            column += length;
+        }
+    }
+    return glyph;
+}
+#endif
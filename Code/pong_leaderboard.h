@@ -0,0 +1,201 @@
+#ifndef PONG_LEADERBOARD_H // Match history and leaderboard: mmap'd append-only record log plus index snapshots (PingPong.c)
+#define PONG_LEADERBOARD_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define LEADERBOARD_TOP 100                  // Best wins kept in the heap and in every index snapshot
+#define LEADERBOARD_GROW 65536               // Records added to the mapping each time the log fills up
+#define LEADERBOARD_RECORD_MAGIC 0x504D5452u  // "RTMP", marks a written record; the preallocated tail is zeros
+#define LEADERBOARD_INDEX_MAGIC "PONGIDX1"
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;                    // CRC-32 of the bytes after this field, a torn write fails it
+    uint64_t sequence;               // Position in the log
+    int64_t endTime;                 // Unix time of the game-over screen
+    uint32_t durationMs;
+    uint8_t twoPlayer;
+    uint8_t level;                   // Level when the match ended
+    uint8_t leftScore, rightScore;
+} MatchRecord;
+_Static_assert(sizeof(MatchRecord) == 32, "MatchRecord is the log's on-disk layout: no padding, same size on every build");
+typedef struct {
+    char magic[8];
+    uint32_t crc;                    // Over the whole snapshot with this field zeroed
+    uint32_t topCount;
+    uint64_t count;                  // Log records covered; later ones are replayed from the log on open
+    uint64_t playerWins, cpuWins, twoPlayerMatches;
+    MatchRecord top[LEADERBOARD_TOP];
+} LeaderboardIndex;
+typedef struct {
+    int fd;
+    MatchRecord* records;            // The log file, mapped shared
+    uint64_t capacity;               // Records the mapping holds
+    uint64_t count;
+    uint64_t playerWins, cpuWins, twoPlayerMatches;
+    MatchRecord top[LEADERBOARD_TOP];    // Min-heap on leaderboardRank, worst kept win at [0]
+    int topCount;
+    uint64_t replayed;               // Records read from the log on open, after the index
+    char indexPath[1024];
+} Leaderboard;
+static inline uint32_t leaderboardCrc(const void* data, size_t length) { // CRC-32 (IEEE), bitwise; a record's covers its last 24 of 32 bytes
+    const unsigned char* p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (length--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+static inline uint32_t leaderboardRecordCrc(const MatchRecord* record) {
+    return leaderboardCrc((const char*)record + 8, sizeof(MatchRecord) - 8);
+}
+static inline uint64_t leaderboardRank(const MatchRecord* r) { // Higher level, then bigger margin, then faster win
+    return ((uint64_t)r->level << 40) | ((uint64_t)(r->leftScore - r->rightScore) << 32) | (UINT32_MAX - r->durationMs);
+}
+static inline void leaderboardSiftDown(Leaderboard* board, int i) {
+    while (true) {
+        int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < board->topCount && leaderboardRank(&board->top[left]) < leaderboardRank(&board->top[smallest])) smallest = left;
+        if (right < board->topCount && leaderboardRank(&board->top[right]) < leaderboardRank(&board->top[smallest])) smallest = right;
+        if (smallest == i) return;
+        MatchRecord swap = board->top[i];
+        board->top[i] = board->top[smallest];
+        board->top[smallest] = swap;
+        i = smallest;
+    }
+}
+static inline void leaderboardCount(Leaderboard* board, const MatchRecord* r) { // Totals and heap, O(log LEADERBOARD_TOP)
+    if (r->twoPlayer) {
+        board->twoPlayerMatches++;
+        return;
+    }
+    if (r->leftScore <= r->rightScore) {
+        board->cpuWins++;
+        return;
+    }
+    board->playerWins++;
+    if (board->topCount < LEADERBOARD_TOP) {
+        int i = board->topCount++;
+        board->top[i] = *r;
+        while (i > 0 && leaderboardRank(&board->top[(i - 1) / 2]) > leaderboardRank(&board->top[i])) {
+            MatchRecord swap = board->top[i];
+            board->top[i] = board->top[(i - 1) / 2];
+            board->top[(i - 1) / 2] = swap;
+            i = (i - 1) / 2;
+        }
+    } else if (leaderboardRank(r) > leaderboardRank(&board->top[0])) {
+        board->top[0] = *r;
+        leaderboardSiftDown(board, 0);
+    }
+}
+static inline bool leaderboardMap(Leaderboard* board, uint64_t capacity) {
+    if (board->records) munmap(board->records, board->capacity * sizeof(MatchRecord));
+    board->records = NULL;
+    if (ftruncate(board->fd, capacity * sizeof(MatchRecord)) != 0) return false;
+    void* mapped = mmap(NULL, capacity * sizeof(MatchRecord), PROT_READ | PROT_WRITE, MAP_SHARED, board->fd, 0);
+    if (mapped == MAP_FAILED) return false;
+    board->records = mapped;
+    board->capacity = capacity;
+    return true;
+}
+static inline bool leaderboardValid(const Leaderboard* board, uint64_t i) {
+    const MatchRecord* r = &board->records[i];
+    return r->magic == LEADERBOARD_RECORD_MAGIC && r->sequence == i && r->crc == leaderboardRecordCrc(r);
+}
+static inline void leaderboardSnapshot(Leaderboard* board) { // Written aside and renamed over, so a crash leaves the old one
+    LeaderboardIndex index;
+    memset(&index, 0, sizeof(index));
+    memcpy(index.magic, LEADERBOARD_INDEX_MAGIC, 8);
+    index.count = board->count;
+    index.playerWins = board->playerWins;
+    index.cpuWins = board->cpuWins;
+    index.twoPlayerMatches = board->twoPlayerMatches;
+    index.topCount = board->topCount;
+    memcpy(index.top, board->top, board->topCount * sizeof(MatchRecord));
+    index.crc = leaderboardCrc(&index, sizeof(index));
+    msync(board->records, board->capacity * sizeof(MatchRecord), MS_SYNC);     // Records the index covers are on disk first
+    char tempPath[1040];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", board->indexPath);
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) return;
+    bool written = fwrite(&index, sizeof(index), 1, file) == 1;
+    written = fflush(file) == 0 && written;
+    fsync(fileno(file));
+    fclose(file);
+    if (written) rename(tempPath, board->indexPath);
+}
+static inline bool leaderboardOpen(Leaderboard* board, const char* path) { // O(index + records since the last snapshot)
+    memset(board, 0, sizeof(*board));
+    snprintf(board->indexPath, sizeof(board->indexPath), "%s.idx", path);
+    board->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (board->fd < 0) return false;
+    struct stat info;
+    fstat(board->fd, &info);
+    uint64_t fileRecords = info.st_size / sizeof(MatchRecord);
+    if (!leaderboardMap(board, fileRecords > 0 ? fileRecords : LEADERBOARD_GROW)) return false;
+    LeaderboardIndex index;
+    FILE* file = fopen(board->indexPath, "rb");
+    bool indexed = file && fread(&index, sizeof(index), 1, file) == 1;
+    if (file) fclose(file);
+    if (indexed) {
+        uint32_t crc = index.crc;
+        index.crc = 0;
+        indexed = memcmp(index.magic, LEADERBOARD_INDEX_MAGIC, 8) == 0 && crc == leaderboardCrc(&index, sizeof(index)) &&
+                  index.count <= board->capacity && index.topCount <= LEADERBOARD_TOP &&
+                  (index.count == 0 || leaderboardValid(board, index.count - 1));     // Index matches this log
+    }
+    if (indexed) {
+        board->count = index.count;
+        board->playerWins = index.playerWins;
+        board->cpuWins = index.cpuWins;
+        board->twoPlayerMatches = index.twoPlayerMatches;
+        board->topCount = index.topCount;
+        memcpy(board->top, index.top, index.topCount * sizeof(MatchRecord));
+    }
+    while (board->count < board->capacity && leaderboardValid(board, board->count)) {     // Up to the first unwritten or torn record
+        leaderboardCount(board, &board->records[board->count]);
+        board->count++;
+        board->replayed++;
+    }
+    return true;
+}
+static inline bool leaderboardAppend(Leaderboard* board, MatchRecord record) {
+    if (board->count == board->capacity && !leaderboardMap(board, board->capacity + LEADERBOARD_GROW)) return false;
+    record.magic = LEADERBOARD_RECORD_MAGIC;
+    record.sequence = board->count;
+    record.crc = leaderboardRecordCrc(&record);
+    board->records[board->count] = record;
+    msync((char*)board->records + ((board->count * sizeof(MatchRecord)) & ~(uint64_t)4095), 4096, MS_ASYNC);
+    board->count++;
+    leaderboardCount(board, &record);
+    return true;
+}
+static inline int leaderboardTop(const Leaderboard* board, MatchRecord* out, int n) { // Best first, O(LEADERBOARD_TOP log)
+    Leaderboard heap;
+    heap.topCount = board->topCount;
+    memcpy(heap.top, board->top, board->topCount * sizeof(MatchRecord));
+    int sorted = heap.topCount;
+    while (heap.topCount > 0) {      // Heap sort in place: repeatedly move the worst to the end
+        MatchRecord worst = heap.top[0];
+        heap.top[0] = heap.top[--heap.topCount];
+        leaderboardSiftDown(&heap, 0);
+        heap.top[heap.topCount] = worst;
+    }
+    if (n > sorted) n = sorted;
+    memcpy(out, heap.top, n * sizeof(MatchRecord));
+    return n;
+}
+static inline void leaderboardClose(Leaderboard* board) {
+    if (board->records) {
+        leaderboardSnapshot(board);
+        munmap(board->records, board->capacity * sizeof(MatchRecord));
+    }
+    if (board->fd >= 0) close(board->fd);
+    board->records = NULL;
+}
+#endif
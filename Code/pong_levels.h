@@ -0,0 +1,98 @@
+#ifndef PONG_LEVELS_H // Per-level physics, CPU and palette: built in, or loaded and checked once from a text file (--levels)
+#define PONG_LEVELS_H
+#include <stdio.h>
+#include <string.h>
+#include "pong_sim.h"
+#if !defined(RL_COLOR_TYPE) && !defined(RAYLIB_H)     // Same layout as raylib's, so the tools build without it
+typedef struct Color {
+    unsigned char r, g, b, a;
+} Color;
+#define RL_COLOR_TYPE
+#endif
+#define PONG_MAX_TRAIL 10            // The trail's alpha steps reach 0 after 10 circles
+typedef struct {                     // Everything drawGame needs per level, worked out at load time
+    Color background, paddle, ball, label;
+    int trailLength;                 // Circles drawn behind the ball
+    Color trail[PONG_MAX_TRAIL];     // Ball color at each circle's alpha
+    float trailRadius[PONG_MAX_TRAIL];
+    char name[20];                   // "Level: n"
+} PongTheme;
+static PongTheme pongThemes[PONG_MAX_LEVELS];
+static inline const PongTheme* pongTheme(int level) { // Out-of-range levels use the nearest defined one, like pongLevel()
+    if (level < 1) level = 1;
+    if (level > pongLevelCount) level = pongLevelCount;
+    return &pongThemes[level - 1];
+}
+static inline Color pongRgb(unsigned int rgb) {
+    return (Color){ rgb >> 16 & 255, rgb >> 8 & 255, rgb & 255, 255 };
+}
+static inline void pongBuildTheme(PongTheme* theme, int level, Color background, Color paddle, Color ball, Color label, int trailLength) {
+    theme->background = background;
+    theme->paddle = paddle;
+    theme->ball = ball;
+    theme->label = label;
+    theme->trailLength = trailLength;
+    for (int i = 0; i < trailLength; i++) {
+        theme->trail[i] = ball;
+        theme->trail[i].a = (unsigned char)(255.0f * (0.3f - i * 0.03f));     // Fade(ballColor, 0.3f - i * 0.03f)
+        theme->trailRadius[i] = BALL_RADIUS - i * 0.5f;
+    }
+    snprintf(theme->name, sizeof(theme->name), "Level: %d", level);
+}
+static inline void pongDefaultThemes() { // The three original levels: dark blue, dark green, dark purple
+    pongBuildTheme(&pongThemes[0], 1, pongRgb(0x141432), pongRgb(0xFFFFFF), pongRgb(0xFFFFFF), pongRgb(0x66BFFF), 5);
+    pongBuildTheme(&pongThemes[1], 2, pongRgb(0x143214), pongRgb(0x009E2F), pongRgb(0xFDF900), pongRgb(0x00E430), 7);
+    pongBuildTheme(&pongThemes[2], 3, pongRgb(0x321432), pongRgb(0xE62937), pongRgb(0xFF6464), pongRgb(0xFF00FF), 9);
+}
+static inline bool pongLoadLevels(const char* path) { // NULL: built-in levels. All or nothing: a bad file leaves them in place
+    pongDefaultThemes();
+    if (!path) return true;
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Cannot read levels from %s\n", path);
+        return false;
+    }
+    static PongLevel levels[PONG_MAX_LEVELS];
+    static PongTheme themes[PONG_MAX_LEVELS];
+    char line[256];
+    int count = 0, lineNumber = 0;
+    const char* problem = NULL;
+    while (!problem && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* text = line + strspn(line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\0') continue;
+        PongLevel level;
+        int predicts, trailLength;
+        unsigned int background, paddle, ball, label;
+        if (count == PONG_MAX_LEVELS) problem = "too many levels";
+        else if (sscanf(text, "%f %f %d %f %f %f %d %x %x %x %x %d", &level.serveSpeedMultiplier, &level.minBounceSpeed, &predicts,
+                        &level.difficultyFactor, &level.errorRange, &level.aiSpeed, &level.reactionTimeMs,
+                        &background, &paddle, &ball, &label, &trailLength) != 12) problem = "expected 12 fields";
+        else if (!(level.serveSpeedMultiplier > 0 && INITIAL_BALL_SPEED * level.serveSpeedMultiplier <= MAX_BALL_SPEED)) problem = "serve out of range";
+        else if (!(level.minBounceSpeed > 0 && level.minBounceSpeed <= MAX_BALL_SPEED)) problem = "bounce speed out of range";
+        else if (predicts != 0 && predicts != 1) problem = "predicts must be 0 or 1";
+        else if (!(level.difficultyFactor > 0 && level.difficultyFactor <= 2)) problem = "difficulty out of range";
+        else if (!(level.errorRange >= 0 && level.errorRange <= SCREEN_HEIGHT)) problem = "aim error out of range";
+        else if (!(level.aiSpeed > 0 && level.aiSpeed * level.difficultyFactor <= PADDLE_HEIGHT / 2)) problem = "CPU speed out of range";
+        else if (level.reactionTimeMs < 0 || level.reactionTimeMs > 2000) problem = "reaction time out of range";
+        else if ((background | paddle | ball | label) > 0xFFFFFF) problem = "colors are RRGGBB";
+        else if (trailLength < 0 || trailLength > PONG_MAX_TRAIL) problem = "trail out of range";
+        else {
+            level.predictsBounce = predicts;
+            levels[count] = level;
+            pongBuildTheme(&themes[count], count + 1, pongRgb(background), pongRgb(paddle), pongRgb(ball), pongRgb(label), trailLength);
+            count++;
+        }
+    }
+    fclose(file);
+    if (!problem && count == 0) problem = "no levels";
+    if (problem) {
+        printf("%s:%d: %s, keeping the built-in levels\n", path, lineNumber, problem);
+        return false;
+    }
+    memcpy(pongLevels, levels, count * sizeof(PongLevel));
+    memcpy(pongThemes, themes, count * sizeof(PongTheme));
+    pongLevelCount = count;
+    return true;
+}
+#endif
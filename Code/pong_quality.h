@@ -0,0 +1,101 @@
+#ifndef PONG_QUALITY_H // Frame-time quality governor for the raylib builds: steps effects down when frames overrun, back up when they hold
+#define PONG_QUALITY_H
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#define PONG_QUALITY_TIERS 4
+#define PONG_QUALITY_WINDOW 30       // Frames per decision, half a second at 60 FPS
+#define PONG_QUALITY_DROP_FRAMES 3   // Overloaded frames in one window that step the tier down
+#define PONG_QUALITY_WORK_HIGH 0.8f  // A frame whose work passes this share of the budget is overloaded,
+#define PONG_QUALITY_MISSED 1.2f     // and so is one shown this many budgets after the last
+#define PONG_QUALITY_WORK_LOW 0.5f   // Windows working under this share, with no overload, count toward a step up
+#define PONG_QUALITY_RAISE_SECONDS 2.0f     // First wait before a step up; doubles each time one does not hold, up to a minute
+typedef struct {
+    const char* name;
+    int trailLength;                 // Most trail circles, the level's own length when that is shorter
+    int paddleSegments;              // DrawRectangleRounded corner segments, 0 = plain rectangles
+    bool alphaOverlays;              // Translucent boxes behind text; below this tier they are opaque or left out
+    bool effects;                    // Attract match behind the menu
+} PongQualityTier;
+static const PongQualityTier pongQualityTiers[PONG_QUALITY_TIERS] = {     // Cheapest first
+    { "low", 0, 0, false, false },
+    { "medium", 3, 2, false, true },
+    { "high", 6, 4, true, true },
+    { "full", 10, 8, true, true },   // What the builds drew before the governor
+};
+typedef struct {
+    int tier;
+    bool fixed;                      // --quality: the tier never changes
+    float budgetMs;
+    int frames, overloaded;          // This window
+    float workSumMs, windowMs;
+    float workMs;                    // Average frame work over the last full window, for the telemetry line
+    float stableSeconds;             // Under the low mark since the last change
+    float raiseDelay;
+    bool probing;                    // Stepped up and not yet held for raiseDelay
+    long changes;
+    double tierSeconds[PONG_QUALITY_TIERS];
+} PongQuality;
+static inline int pongQualityParse(const char* name) { // -1 for an unknown tier name
+    for (int tier = 0; tier < PONG_QUALITY_TIERS; tier++) {
+        if (strcmp(name, pongQualityTiers[tier].name) == 0) return tier;
+    }
+    return -1;
+}
+static inline void pongQualityInit(PongQuality* quality, float budgetMs, int fixedTier) { // fixedTier -1: governed, starting at full
+    memset(quality, 0, sizeof(*quality));
+    quality->fixed = fixedTier >= 0;
+    quality->tier = quality->fixed ? fixedTier : PONG_QUALITY_TIERS - 1;
+    quality->budgetMs = budgetMs;
+    quality->raiseDelay = PONG_QUALITY_RAISE_SECONDS;
+}
+static inline const PongQualityTier* pongQualityTier(const PongQuality* quality) {
+    return &pongQualityTiers[quality->tier];
+}
+static inline int pongQualityTrail(const PongQuality* quality, int levelTrail) {
+    int trail = pongQualityTier(quality)->trailLength;
+    return levelTrail < trail ? levelTrail : trail;
+}
+static inline bool pongQualityFrame(PongQuality* quality, float workMs, float frameMs, bool mayRaise) { // After each frame; true when the tier changed
+    quality->tierSeconds[quality->tier] += frameMs / 1000.0f;
+    quality->frames++;
+    quality->workSumMs += workMs;
+    quality->windowMs += frameMs;
+    if (workMs > quality->budgetMs * PONG_QUALITY_WORK_HIGH || frameMs > quality->budgetMs * PONG_QUALITY_MISSED) quality->overloaded++;
+    if (quality->frames < PONG_QUALITY_WINDOW) return false;
+    quality->workMs = quality->workSumMs / quality->frames;
+    int overloaded = quality->overloaded, tier = quality->tier;
+    float windowSeconds = quality->windowMs / 1000.0f;
+    quality->frames = quality->overloaded = 0;
+    quality->workSumMs = quality->windowMs = 0.0f;
+    if (quality->fixed) return false;
+    if (overloaded >= PONG_QUALITY_DROP_FRAMES) {     // A few slow frames in half a second: step down now
+        if (quality->probing && quality->raiseDelay < 60.0f) quality->raiseDelay *= 2.0f;     // The last step up did not hold
+        quality->probing = false;
+        quality->stableSeconds = 0.0f;
+        if (tier > 0) tier--;
+    } else if (overloaded == 0 && quality->workMs < quality->budgetMs * PONG_QUALITY_WORK_LOW) {
+        quality->stableSeconds += windowSeconds;
+        if (quality->stableSeconds >= quality->raiseDelay) {
+            quality->probing = false;     // This tier held
+            if (mayRaise && tier < PONG_QUALITY_TIERS - 1) {
+                tier++;
+                quality->probing = true;
+                quality->stableSeconds = 0.0f;
+            }
+        }
+    } else {
+        quality->stableSeconds = 0.0f;     // Between the marks: keep the tier
+    }
+    if (tier == quality->tier) return false;
+    quality->tier = tier;
+    quality->changes++;
+    return true;
+}
+static inline void pongQualityReport(const PongQuality* quality, const char* build) {
+    printf("Quality %s: %s at exit, %s, %ld changes, %.1f ms budget; seconds per tier:", build, pongQualityTier(quality)->name,
+           quality->fixed ? "fixed" : "governed", quality->changes, quality->budgetMs);
+    for (int tier = 0; tier < PONG_QUALITY_TIERS; tier++) printf(" %s %.1f", pongQualityTiers[tier].name, quality->tierSeconds[tier]);
+    printf("\n");
+}
+#endif
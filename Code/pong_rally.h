@@ -0,0 +1,92 @@
+#ifndef PONG_RALLY_H // Rally analytics events and their columnar file (PingPong.c --analytics, rallystats.c)
+#define PONG_RALLY_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#define RALLY_FILE_MAGIC "PONGRALLY1\n"     // Then one line naming the columns, then blocks
+#define RALLY_BLOCK_ROWS 1024               // Most rows per block: uint32 row count, then each column's values back to back
+typedef enum { RALLY_LEFT_HIT, RALLY_RIGHT_HIT, RALLY_WALL, RALLY_LEFT_SCORED, RALLY_RIGHT_SCORED, RALLY_TYPE_COUNT } RallyEventType;
+typedef struct {
+    uint64_t timeNs;                 // CLOCK_MONOTONIC of the ball tick
+    uint32_t rally;                  // Rally number in the session, a new one starts after each point
+    uint32_t rallyHits;              // Paddle hits so far in the rally, the rally length on score events
+    float hitPosition;               // Paddle hits: 0 = top edge, 1 = bottom edge
+    float bounceAngle;               // Paddle hits: radians, negative sends the ball up
+    float speed;                     // Ball speed after the event
+    float x, y;                      // Ball position after the event
+    uint8_t type;                    // RallyEventType
+    uint8_t level;
+    uint8_t leftScore, rightScore;
+} RallyEvent;
+typedef struct {
+    const char* name;
+    size_t offset;
+    size_t size;
+    char kind;                       // 'u' unsigned integer, 'f' float
+} RallyColumn;
+static const RallyColumn rallyColumns[] = {
+    {"time_ns", offsetof(RallyEvent, timeNs), 8, 'u'},
+    {"rally", offsetof(RallyEvent, rally), 4, 'u'},
+    {"rally_hits", offsetof(RallyEvent, rallyHits), 4, 'u'},
+    {"hit_position", offsetof(RallyEvent, hitPosition), 4, 'f'},
+    {"bounce_angle", offsetof(RallyEvent, bounceAngle), 4, 'f'},
+    {"speed", offsetof(RallyEvent, speed), 4, 'f'},
+    {"x", offsetof(RallyEvent, x), 4, 'f'},
+    {"y", offsetof(RallyEvent, y), 4, 'f'},
+    {"type", offsetof(RallyEvent, type), 1, 'u'},
+    {"level", offsetof(RallyEvent, level), 1, 'u'},
+    {"left_score", offsetof(RallyEvent, leftScore), 1, 'u'},
+    {"right_score", offsetof(RallyEvent, rightScore), 1, 'u'},
+};
+#define RALLY_COLUMN_COUNT ((int)(sizeof(rallyColumns) / sizeof(rallyColumns[0])))
+static inline const char* rallyTypeName(int type) { // A function, so builds that only write the log carry no unused table
+    static const char* names[RALLY_TYPE_COUNT] = {"left_hit", "right_hit", "wall", "left_scored", "right_scored"};
+    return type >= 0 && type < RALLY_TYPE_COUNT ? names[type] : "?";
+}
+static inline void rallyColumnLine(char* line, size_t size) { // e.g. "time_ns:u8 rally:u4 ...", checked by the reader
+    line[0] = '\0';
+    for (int c = 0; c < RALLY_COLUMN_COUNT; c++) {
+        snprintf(line + strlen(line), size - strlen(line), "%s%s:%c%zu", c ? " " : "", rallyColumns[c].name,
+                 rallyColumns[c].kind, rallyColumns[c].size);
+    }
+    strncat(line, "\n", size - strlen(line) - 1);
+}
+static inline void rallyWriteHeader(FILE* file) {
+    char line[512];
+    rallyColumnLine(line, sizeof(line));
+    fputs(RALLY_FILE_MAGIC, file);
+    fputs(line, file);
+}
+static inline void rallyWriteBlock(FILE* file, const RallyEvent* events, uint32_t rows) { // rows <= RALLY_BLOCK_ROWS
+    unsigned char column[RALLY_BLOCK_ROWS * 8];
+    fwrite(&rows, sizeof(rows), 1, file);
+    for (int c = 0; c < RALLY_COLUMN_COUNT; c++) {
+        const RallyColumn* col = &rallyColumns[c];
+        for (uint32_t r = 0; r < rows; r++) memcpy(column + r * col->size, (const char*)&events[r] + col->offset, col->size);
+        fwrite(column, col->size, rows, file);
+    }
+}
+static inline int rallyReadHeader(FILE* file) { // 1 when the file is a rally log with this build's columns
+    char magic[32], line[512], expected[512];
+    rallyColumnLine(expected, sizeof(expected));
+    return fgets(magic, sizeof(magic), file) && strcmp(magic, RALLY_FILE_MAGIC) == 0 &&
+           fgets(line, sizeof(line), file) && strcmp(line, expected) == 0;
+}
+static inline uint32_t rallyReadBlock(FILE* file, RallyEvent* events, uint32_t columnMask) { // Only the columns in the mask are read, others are skipped
+    uint32_t rows;
+    unsigned char column[RALLY_BLOCK_ROWS * 8];
+    if (fread(&rows, sizeof(rows), 1, file) != 1 || rows == 0 || rows > RALLY_BLOCK_ROWS) return 0;
+    memset(events, 0, rows * sizeof(RallyEvent));
+    for (int c = 0; c < RALLY_COLUMN_COUNT; c++) {
+        const RallyColumn* col = &rallyColumns[c];
+        if (!(columnMask & (1u << c))) {
+            if (fseek(file, (long)(col->size * rows), SEEK_CUR) != 0) return 0;
+            continue;
+        }
+        if (fread(column, col->size, rows, file) != rows) return 0;
+        for (uint32_t r = 0; r < rows; r++) memcpy((char*)&events[r] + col->offset, column + r * col->size, col->size);
+    }
+    return rows;
+}
+#endif
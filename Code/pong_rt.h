@@ -0,0 +1,55 @@
+#ifndef PONG_RT_H // Thread pinning, SCHED_FIFO and tick interval histograms for --pin-*/--rt/--jitter-report in both game builds
+#define PONG_RT_H
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>                   // CPU_SET and pthread_setaffinity_np need _GNU_SOURCE before the first include
+#define PONG_JITTER_BINS 2000        // Histogram bins; the last one collects everything longer
+typedef struct {
+    double binUs;                    // Bin width, set by the build: PongJitterStats stats = { .binUs = 50 }
+    long counts[PONG_JITTER_BINS + 1];
+    long total;
+    double sumUs, minUs, maxUs;
+} PongJitterStats;
+static inline void pongConfigureThread(pthread_t thread, const char* role, int cpu, bool realtime) { // Best effort, reports what it could not do
+    if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        int ret = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        if (ret != 0) printf("Could not pin %s thread to CPU %d: %s\n", role, cpu, strerror(ret));
+        else printf("%s thread pinned to CPU %d\n", role, cpu);
+    }
+    if (realtime) {
+        struct sched_param param = { .sched_priority = sched_get_priority_min(SCHED_FIFO) + 10 };
+        int ret = pthread_setschedparam(thread, SCHED_FIFO, &param);
+        if (ret != 0) printf("Could not give %s thread SCHED_FIFO: %s\n", role, strerror(ret));
+        else printf("%s thread running SCHED_FIFO priority %d\n", role, param.sched_priority);
+    }
+}
+static inline void pongRecordTickInterval(PongJitterStats* stats, double intervalUs) {
+    int bin = (int)(intervalUs / stats->binUs);
+    stats->counts[bin < PONG_JITTER_BINS ? bin : PONG_JITTER_BINS]++;
+    if (stats->total == 0 || intervalUs < stats->minUs) stats->minUs = intervalUs;
+    if (intervalUs > stats->maxUs) stats->maxUs = intervalUs;
+    stats->sumUs += intervalUs;
+    stats->total++;
+}
+static inline void pongPrintJitterReport(const PongJitterStats* stats, const char* role, double nominalUs) {
+    if (stats->total == 0) return;
+    const double percentiles[] = {50, 90, 99, 99.9};
+    printf("%s tick intervals over %ld ticks (nominal %.1f ms):\n", role, stats->total, nominalUs / 1000);
+    printf("  min %.3f ms  mean %.3f ms  max %.3f ms\n", stats->minUs / 1000, stats->sumUs / stats->total / 1000, stats->maxUs / 1000);
+    for (int p = 0; p < 4; p++) {
+        long target = (long)(stats->total * percentiles[p] / 100.0), seen = 0;
+        int bin = 0;
+        for (; bin < PONG_JITTER_BINS; bin++) {
+            seen += stats->counts[bin];
+            if (seen > target) break;
+        }
+        printf("  p%-5g %s%.2f ms (%+.2f ms late)\n", percentiles[p], bin == PONG_JITTER_BINS ? ">" : "<",
+               (bin + 1) * stats->binUs / 1000.0, ((bin + 1) * stats->binUs - nominalUs) / 1000);
+    }
+}
+#endif
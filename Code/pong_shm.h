@@ -0,0 +1,88 @@
+#ifndef PONG_SHM_H // Live game state in POSIX shared memory, seqlock guarded (PingPong.c --export-state, shmtail.c)
+#define PONG_SHM_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#define PONG_SHM_NAME "/pingpong-state"
+#define PONG_SHM_VERSION 1
+typedef struct {
+    uint64_t tick;                   // Ball thread ticks since the game started, also while paused
+    int64_t timeNs;                  // CLOCK_MONOTONIC when the tick was published
+    float ballX, ballY;
+    float ballVelocityX, ballVelocityY;
+    float leftPaddleY, rightPaddleY;
+    int32_t leftScore, rightScore;
+    int32_t level;
+    uint8_t twoPlayer;
+    uint8_t paused;
+    uint8_t gameOver;
+    uint8_t modeSelected;            // 0 while the mode selection screen is up
+} PongLiveState;
+typedef struct {
+    atomic_uint version;             // PONG_SHM_VERSION, readers refuse other layouts
+    uint32_t size;                   // sizeof(PongShmSegment)
+    atomic_uint sequence;            // Odd while the game is writing state
+    uint32_t writerPid;
+    PongLiveState state;
+} PongShmSegment;
+static inline PongShmSegment* pongShmCreate(const char* name) { // Game side; NULL when shared memory is unavailable
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return NULL;
+    if (ftruncate(fd, sizeof(PongShmSegment)) != 0) {
+        close(fd);
+        return NULL;
+    }
+    PongShmSegment* segment = mmap(NULL, sizeof(PongShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) return NULL;
+    atomic_store(&segment->version, 0);     // Segment left by an earlier run: readers stop trusting it until it is reset
+    unsigned int sequence = atomic_load(&segment->sequence);
+    if (sequence & 1) atomic_store(&segment->sequence, sequence + 1);     // That run died mid-write
+    memset(&segment->state, 0, sizeof(segment->state));
+    segment->size = sizeof(PongShmSegment);
+    segment->writerPid = getpid();
+    atomic_store_explicit(&segment->version, PONG_SHM_VERSION, memory_order_release);     // Last, readers wait for it
+    return segment;
+}
+static inline void pongShmPublish(PongShmSegment* segment, const PongLiveState* state) { // Single writer, never blocks
+    unsigned int sequence = atomic_load_explicit(&segment->sequence, memory_order_relaxed);
+    atomic_store_explicit(&segment->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&segment->state, state, sizeof(*state));
+    atomic_store_explicit(&segment->sequence, sequence + 2, memory_order_release);
+}
+static inline void pongShmDestroy(PongShmSegment* segment, const char* name) {
+    munmap(segment, sizeof(PongShmSegment));
+    shm_unlink(name);
+}
+static inline const PongShmSegment* pongShmOpen(const char* name) { // Reader side, read-only mapping; NULL until the game has created it
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    const PongShmSegment* segment = mmap(NULL, sizeof(PongShmSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) return NULL;
+    if (atomic_load_explicit(&segment->version, memory_order_acquire) != PONG_SHM_VERSION ||
+        segment->size != sizeof(PongShmSegment)) {
+        munmap((void*)segment, sizeof(PongShmSegment));
+        return NULL;
+    }
+    return segment;
+}
+static inline int pongShmRead(const PongShmSegment* segment, PongLiveState* out, int maxRetries) { // Retries used, -1 if every attempt was torn
+    for (int attempt = 0; attempt <= maxRetries; attempt++) {
+        unsigned int before = atomic_load_explicit(&segment->sequence, memory_order_acquire);
+        if (before & 1) continue;    // Writer is mid-update
+        memcpy(out, (const void*)&segment->state, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&segment->sequence, memory_order_relaxed) == before) return attempt;
+    }
+    return -1;
+}
+static inline void pongShmClose(const PongShmSegment* segment) {
+    munmap((void*)segment, sizeof(PongShmSegment));
+}
+#endif
@@ -0,0 +1,240 @@
+#ifndef PONG_SIM_H // Ball physics and CPU paddle logic of PingPong.c, shared with the headless tools (tournament.c)
+#define PONG_SIM_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 800
+#define PADDLE_WIDTH 20
+#define PADDLE_HEIGHT 100
+#define BALL_RADIUS 10
+#define PADDLE_SPEED 7.0f
+#define INITIAL_BALL_SPEED 7.5f
+#define MAX_BALL_SPEED 15.0f
+#define MAX_SCORE 10
+#define AI_THINK_MS 16               // aiThreadFunc's fixed sleep, one ball tick
+#define PONG_LEVEL_COUNT 3           // Built-in levels; a levels file (pong_levels.h) can define up to PONG_MAX_LEVELS
+#define PONG_MAX_LEVELS 32
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+#if !defined(RL_VECTOR2_TYPE) && !defined(RAYLIB_H)     // Same layout as raylib's, so the tools build without it
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+typedef struct {
+    uint64_t state;
+} PongRng;
+typedef struct {
+    float leftPaddleY;
+    float rightPaddleY;
+    Vector2 ballPosition;
+    Vector2 ballVelocity;
+    int leftScore;
+    int rightScore;
+    bool gameOver;
+    int level;
+    PongRng rng;                     // Seeded once, so a match replays exactly from its seed
+} PongMatch;
+#define PONG_MATCH_SNAPSHOT_VERSION 1    // Bump with any change to PongMatch or PongMatchSnapshot
+typedef struct {                     // Everything needed to resume a match: F5/F8, --resume and each .states record
+    PongMatch match;
+    uint64_t ballTicks;
+    uint8_t twoPlayerMode;
+    uint8_t gamePaused;
+    uint8_t modeSelected;
+    uint8_t reserved;
+} PongMatchSnapshot;
+typedef struct {
+    float serveSpeedMultiplier;      // Ball speed after a point, times INITIAL_BALL_SPEED
+    float minBounceSpeed;            // Kick-off speed and the floor for speed after a paddle hit
+    bool predictsBounce;             // CPU: aims at where the ball will arrive instead of where it is
+    float difficultyFactor;          // CPU: how much it trusts its prediction, also scales its moves
+    float errorRange;                // CPU: random aim error in pixels
+    float aiSpeed;                   // CPU: paddle move per tick, before difficultyFactor
+    int reactionTimeMs;              // CPU: how late it sees the ball
+} PongLevel;
+#define PONG_AI_HISTORY 128          // Ball ticks a controller remembers, a power of two; reaction times up to ~2 s
+typedef struct {
+    Vector2 ballPosition;
+    Vector2 ballVelocity;
+} PongAiSighting;
+typedef struct {                     // A CPU paddle stepped by ball ticks: sees the ball delayTicks late, no thread or sleep of its own
+    PongAiSighting seen[PONG_AI_HISTORY];     // Ring of the ball as it was on each tick, from its own side
+    uint64_t sightings;
+    const PongLevel* tuning;         // NULL: plays at the match's level
+    int delayTicks;                  // -1: from the level's reactionTimeMs
+    bool leftSide;                   // Plays the left paddle through pongMirror
+    PongRng rng;                     // Own stream, so the match RNG is only drawn by the ball
+} PongAiController;
+#ifdef PONG_LEVELS_FILE              // gcc -DPONG_LEVELS_FILE='"ai_levels.h"' to build with a table from calibrate.c
+#include PONG_LEVELS_FILE
+#else
+static PongLevel pongLevels[PONG_MAX_LEVELS] = {
+    { 1.0f, INITIAL_BALL_SPEED * 1.2f, false, 0.65f, 75.0f, PADDLE_SPEED * 0.25f, 55 },  // Level 1
+    { 1.5f, INITIAL_BALL_SPEED * 1.4f, true, 0.90f, 50.0f, PADDLE_SPEED * 0.42f, 30 },   // Level 2
+    { 2.0f, INITIAL_BALL_SPEED * 1.6f, true, 1.15f, 25.0f, PADDLE_SPEED * 1.4f, 5 },     // Level 3
+};
+#endif
+static int pongLevelCount = PONG_LEVEL_COUNT;     // Entries of pongLevels in use, replaced by pongLoadLevels()
+enum {                               // pongStepBall() result bits
+    PONG_EVENT_WALL = 1,
+    PONG_EVENT_LEFT_PADDLE = 2,
+    PONG_EVENT_RIGHT_PADDLE = 4,
+    PONG_EVENT_LEFT_SCORED = 8,
+    PONG_EVENT_RIGHT_SCORED = 16
+};
+static inline uint64_t pongRandomNext(PongRng* rng) { // splitmix64
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+static inline int pongRandomValue(PongRng* rng, int min, int max) { // Inclusive, like raylib's GetRandomValue
+    return min + (int)(pongRandomNext(rng) % (uint64_t)(max - min + 1));
+}
+static inline const PongLevel* pongLevel(int level) { // Out-of-range levels use the nearest defined one
+    if (level < 1) level = 1;
+    if (level > pongLevelCount) level = pongLevelCount;
+    return &pongLevels[level - 1];
+}
+static inline float pongSpeed(Vector2 v) {
+    return sqrtf(v.x * v.x + v.y * v.y);
+}
+static inline void pongServe(PongMatch* match) { // Kick-off after a (re)start, random direction
+    match->ballPosition.x = SCREEN_WIDTH / 2;
+    match->ballPosition.y = SCREEN_HEIGHT / 2;
+    float initialSpeed = pongLevel(match->level)->minBounceSpeed;
+    match->ballVelocity.x = initialSpeed * (pongRandomValue(&match->rng, 0, 1) ? 1 : -1);
+    match->ballVelocity.y = initialSpeed * 0.5f * (pongRandomValue(&match->rng, 0, 1) ? 1 : -1);
+}
+static inline void pongInitMatch(PongMatch* match, int level, uint64_t seed) {
+    match->rng.state = seed;
+    match->leftPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
+    match->rightPaddleY = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2;
+    match->leftScore = 0;
+    match->rightScore = 0;
+    match->gameOver = false;
+    match->level = level;
+    pongServe(match);
+}
+static inline void pongResetBall(PongMatch* match, float direction) { // After a point, direction +1 sends it right
+    match->ballPosition.x = SCREEN_WIDTH / 2;
+    match->ballPosition.y = SCREEN_HEIGHT / 2;
+    float levelSpeedMultiplier = pongLevel(match->level)->serveSpeedMultiplier;
+    match->ballVelocity.x = direction * INITIAL_BALL_SPEED * levelSpeedMultiplier;
+    match->ballVelocity.y = INITIAL_BALL_SPEED * (pongRandomValue(&match->rng, 0, 1) ? 1 : -1) *
+                            (0.6f + ((float)pongRandomValue(&match->rng, 0, 40) / 100.0f)) * levelSpeedMultiplier;
+}
+static inline float pongBounceSpeed(const PongMatch* match) {
+    float newSpeed = fmaxf(pongSpeed(match->ballVelocity), pongLevel(match->level)->minBounceSpeed);
+    return fminf(newSpeed * 1.05f, MAX_BALL_SPEED);
+}
+static inline int pongStepBall(PongMatch* match) { // One ballThreadFunc tick, returns PONG_EVENT_* bits
+    int events = 0;
+    match->ballPosition.x += match->ballVelocity.x;
+    match->ballPosition.y += match->ballVelocity.y;
+    if (match->ballPosition.y <= 0 || match->ballPosition.y >= SCREEN_HEIGHT) {         // Ball collision with top and bottom walls
+        match->ballVelocity.y *= -1.0f;
+        events |= PONG_EVENT_WALL;
+        if (match->ballPosition.y < 0) match->ballPosition.y = 0;             // Ensure ball stays within bounds
+        if (match->ballPosition.y > SCREEN_HEIGHT) match->ballPosition.y = SCREEN_HEIGHT;
+    }
+    if (match->ballPosition.x - BALL_RADIUS <= PADDLE_WIDTH &&
+        match->ballPosition.y >= match->leftPaddleY &&
+        match->ballPosition.y <= match->leftPaddleY + PADDLE_HEIGHT) {
+        float hitPosition = (match->ballPosition.y - match->leftPaddleY) / PADDLE_HEIGHT;             // Calculate reflection angle based on where ball hits paddle
+        float bounceAngle = (hitPosition - 0.5f) * PI/3; // Between -PI/6 and PI/6 radians
+        float newSpeed = pongBounceSpeed(match);
+        match->ballVelocity.x = fabsf(newSpeed * cosf(bounceAngle)); // Force positive x direction
+        match->ballVelocity.y = newSpeed * sinf(bounceAngle);
+        match->ballPosition.x = PADDLE_WIDTH + BALL_RADIUS + 1;             // Move ball outside paddle to prevent multiple collisions
+        events |= PONG_EVENT_LEFT_PADDLE;
+    }
+    if (match->ballPosition.x + BALL_RADIUS >= SCREEN_WIDTH - PADDLE_WIDTH &&
+        match->ballPosition.y >= match->rightPaddleY &&
+        match->ballPosition.y <= match->rightPaddleY + PADDLE_HEIGHT) {
+        float hitPosition = (match->ballPosition.y - match->rightPaddleY) / PADDLE_HEIGHT;
+        float bounceAngle = (hitPosition - 0.5f) * PI/3;
+        float newSpeed = pongBounceSpeed(match);
+        match->ballVelocity.x = -fabsf(newSpeed * cosf(bounceAngle)); // Force negative x direction
+        match->ballVelocity.y = newSpeed * sinf(bounceAngle);
+        match->ballPosition.x = SCREEN_WIDTH - PADDLE_WIDTH - BALL_RADIUS - 1;
+        events |= PONG_EVENT_RIGHT_PADDLE;
+    }
+    if (match->ballPosition.x < 0) {
+        match->rightScore++;
+        events |= PONG_EVENT_RIGHT_SCORED;
+        pongResetBall(match, 1.0f);
+        if (match->rightScore >= MAX_SCORE) match->gameOver = true;
+    }
+    if (match->ballPosition.x > SCREEN_WIDTH) {
+        match->leftScore++;
+        events |= PONG_EVENT_LEFT_SCORED;
+        pongResetBall(match, -1.0f);
+        if (match->leftScore >= MAX_SCORE) match->gameOver = true;
+    }
+    return events;
+}
+static inline void pongClampPaddle(float* paddleY) {
+    if (*paddleY < 0) *paddleY = 0;
+    if (*paddleY > SCREEN_HEIGHT - PADDLE_HEIGHT) *paddleY = SCREEN_HEIGHT - PADDLE_HEIGHT;
+}
+static inline float pongAiMove(const PongMatch* match, const PongLevel* ai, PongRng* rng) { // One aiThreadFunc decision for the right paddle, returns the move
+    if (match->ballVelocity.x > 0) {
+        float targetY = match->ballPosition.y;
+        if (ai->predictsBounce) {
+            float timeToReach = (SCREEN_WIDTH - PADDLE_WIDTH - match->ballPosition.x) / match->ballVelocity.x;
+            float predictedY = match->ballPosition.y + (match->ballVelocity.y * timeToReach);
+            while (predictedY < 0 || predictedY > SCREEN_HEIGHT) {
+                if (predictedY < 0) predictedY = -predictedY;
+                if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
+            }
+            targetY = predictedY * ai->difficultyFactor + match->ballPosition.y * (1 - ai->difficultyFactor);
+        }
+        targetY += (pongRandomValue(rng, -100, 100) / 100.0f) * ai->errorRange;
+        if (targetY < match->rightPaddleY + PADDLE_HEIGHT/2 - 10) return -ai->aiSpeed * ai->difficultyFactor;
+        if (targetY > match->rightPaddleY + PADDLE_HEIGHT/2 + 10) return ai->aiSpeed * ai->difficultyFactor;
+    } else {
+        if (match->rightPaddleY + PADDLE_HEIGHT/2 < SCREEN_HEIGHT/2 - 20) return PADDLE_SPEED * 0.5f;
+        if (match->rightPaddleY + PADDLE_HEIGHT/2 > SCREEN_HEIGHT/2 + 20) return -PADDLE_SPEED * 0.5f;
+    }
+    return 0.0f;
+}
+static inline PongMatch pongMirror(const PongMatch* match) { // Swap sides, so right-paddle logic can play the left paddle
+    PongMatch mirrored = *match;
+    mirrored.leftPaddleY = match->rightPaddleY;
+    mirrored.rightPaddleY = match->leftPaddleY;
+    mirrored.ballPosition.x = SCREEN_WIDTH - match->ballPosition.x;
+    mirrored.ballVelocity.x = -match->ballVelocity.x;
+    mirrored.leftScore = match->rightScore;
+    mirrored.rightScore = match->leftScore;
+    return mirrored;
+}
+static inline int pongAiReactionTicks(const PongLevel* ai) { // How stale the CPU's view of the ball is: reactionTimeMs in ball ticks
+    int ticks = (ai->reactionTimeMs + AI_THINK_MS / 2) / AI_THINK_MS;
+    return ticks < PONG_AI_HISTORY ? ticks : PONG_AI_HISTORY - 1;
+}
+static inline void pongAiInit(PongAiController* ai, bool leftSide, uint64_t seed) {
+    ai->sightings = 0;
+    ai->tuning = NULL;
+    ai->delayTicks = -1;
+    ai->leftSide = leftSide;
+    ai->rng.state = seed;
+}
+static inline float pongAiTick(PongAiController* ai, const PongMatch* match) { // Once per ball tick, before pongStepBall: the move for its paddle
+    PongMatch view = ai->leftSide ? pongMirror(match) : *match;
+    ai->seen[ai->sightings++ % PONG_AI_HISTORY] = (PongAiSighting){ view.ballPosition, view.ballVelocity };
+    const PongLevel* level = ai->tuning ? ai->tuning : pongLevel(match->level);     // Decides every tick; reaction time is only how late it sees
+    uint64_t delay = ai->delayTicks >= 0 ? (uint64_t)ai->delayTicks : (uint64_t)pongAiReactionTicks(level);
+    if (delay > ai->sightings - 1) delay = ai->sightings - 1;     // Just (re)started: the oldest sighting there is
+    if (delay > PONG_AI_HISTORY - 1) delay = PONG_AI_HISTORY - 1;
+    const PongAiSighting* seen = &ai->seen[(ai->sightings - 1 - delay) % PONG_AI_HISTORY];
+    view.ballPosition = seen->ballPosition;     // Its own paddle is always current, only the ball is seen late
+    view.ballVelocity = seen->ballVelocity;
+    return pongAiMove(&view, level, &ai->rng);
+}
+#endif
@@ -0,0 +1,76 @@
+#ifndef PONG_SNAPSHOT_H // Versioned fixed-layout binary snapshots: 16-byte header, then one or more raw payload records
+#define PONG_SNAPSHOT_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#define PONG_SNAPSHOT_MAGIC "PONGSNAP"
+enum { PONG_SNAPSHOT_MATCH = 1, PONG_SNAPSHOT_CONSOLE = 2 };     // Payload kinds: PingPong.c, PingPong(WithoutGraphics).c
+typedef struct {
+    char magic[8];
+    uint16_t kind;
+    uint16_t version;                // Bumped whenever the payload struct changes
+    uint32_t payloadSize;            // sizeof one record, checked against the reader's struct
+} PongSnapshotHeader;
+typedef struct {
+    char path[1024];
+    PongSnapshotHeader header;
+    unsigned char payload[];
+} PongSnapshotJob;
+static inline PongSnapshotHeader pongSnapshotHeader(uint16_t kind, uint16_t version, uint32_t payloadSize) {
+    PongSnapshotHeader header = { .kind = kind, .version = version, .payloadSize = payloadSize };
+    memcpy(header.magic, PONG_SNAPSHOT_MAGIC, 8);
+    return header;
+}
+static inline bool pongSnapshotSave(const char* path, uint16_t kind, uint16_t version, const void* payload, uint32_t size) { // Atomic: written aside, renamed over
+    char tempPath[1040];
+    snprintf(tempPath, sizeof(tempPath), "%s.%lx.tmp", path, (unsigned long)pthread_self());     // Two saves in flight never share a temp file
+    FILE* file = fopen(tempPath, "wb");
+    if (!file) return false;
+    PongSnapshotHeader header = pongSnapshotHeader(kind, version, size);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(payload, size, 1, file) == 1;
+    written = fflush(file) == 0 && written;
+    if (written) fsync(fileno(file));
+    fclose(file);
+    if (!written || rename(tempPath, path) != 0) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+static inline void* pongSnapshotWriter(void* arg) {
+    PongSnapshotJob* job = arg;
+    if (!pongSnapshotSave(job->path, job->header.kind, job->header.version, job->payload, job->header.payloadSize)) {
+        printf("Could not write snapshot %s\n", job->path);
+    }
+    free(job);
+    return NULL;
+}
+static inline bool pongSnapshotSaveAsync(const char* path, uint16_t kind, uint16_t version, const void* payload, uint32_t size) { // Copies the payload, file I/O runs on a detached thread
+    PongSnapshotJob* job = malloc(sizeof(PongSnapshotJob) + size);
+    if (!job) return false;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+    job->header = pongSnapshotHeader(kind, version, size);
+    memcpy(job->payload, payload, size);
+    pthread_t writer;
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    bool started = pthread_create(&writer, &attributes, pongSnapshotWriter, job) == 0;
+    pthread_attr_destroy(&attributes);
+    if (!started) free(job);
+    return started;
+}
+static inline bool pongSnapshotLoad(const char* path, uint16_t kind, uint16_t version, void* payload, uint32_t size, long index) { // index picks a record in a multi-record file
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    PongSnapshotHeader header, expected = pongSnapshotHeader(kind, version, size);
+    bool loaded = fread(&header, sizeof(header), 1, file) == 1 && memcmp(&header, &expected, sizeof(header)) == 0 &&
+                  fseek(file, (long)sizeof(header) + index * (long)size, SEEK_SET) == 0 && fread(payload, size, 1, file) == 1;
+    fclose(file);
+    return loaded;
+}
+#endif
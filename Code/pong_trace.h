@@ -0,0 +1,111 @@
+#ifndef PONG_TRACE_H // Zone tracer for --trace: per-thread preallocated buffers, exported as Chrome/Perfetto trace JSON
+#define PONG_TRACE_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#define PONG_TRACE_EVENTS 262144     // Per thread, a power of two: the newest are kept, minutes of every thread at 60 Hz
+#define PONG_TRACE_MAX_THREADS 16
+#define PONG_TRACE_SLACK 4096        // Oldest events skipped when exporting a full ring while it is written
+typedef struct {
+    const char* name;                // A string literal: only the pointer is stored
+    int64_t startNs;                 // CLOCK_MONOTONIC
+    int64_t durationNs;
+} PongTraceEvent;
+typedef struct {
+    PongTraceEvent* events;
+    atomic_long count;               // Events ever written by the owning thread; the next goes to count % PONG_TRACE_EVENTS
+    int tid;
+    char name[16];
+    atomic_bool ready;               // Set last by pongTraceRegister: the fields above may be read
+} PongTraceBuffer;
+typedef struct {
+    const char* name;
+    int64_t startNs;
+} PongTraceZone;
+static bool pongTraceOn;             // Set once before the threads start; off, a zone costs a well-predicted branch
+static PongTraceBuffer pongTraceBuffers[PONG_TRACE_MAX_THREADS];
+static atomic_int pongTraceThreadCount;     // Slots claimed; a slot is only read once its ready flag is set
+static atomic_long pongTraceLost;    // Events from threads beyond PONG_TRACE_MAX_THREADS
+static _Thread_local PongTraceBuffer* pongTraceLocal;
+static _Thread_local bool pongTraceUntraced;     // No slot or no memory: stop trying to register
+static _Thread_local const char* pongTraceThreadName;
+static inline int64_t pongTraceNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+static inline void pongTraceThread(const char* name) { // Names the calling thread's track; its buffer is made on its first event
+    pongTraceThreadName = name;
+}
+static inline PongTraceBuffer* pongTraceRegister() { // Once per thread: allocates and touches the buffer so tracing never page-faults later
+    pongTraceUntraced = true;
+    int index = atomic_fetch_add(&pongTraceThreadCount, 1);
+    if (index >= PONG_TRACE_MAX_THREADS) return NULL;
+    PongTraceBuffer* buffer = &pongTraceBuffers[index];
+    buffer->events = calloc(PONG_TRACE_EVENTS, sizeof(PongTraceEvent));
+    if (!buffer->events) return NULL;
+    memset(buffer->events, 0, PONG_TRACE_EVENTS * sizeof(PongTraceEvent));
+    buffer->tid = (int)syscall(SYS_gettid);
+    snprintf(buffer->name, sizeof(buffer->name), "%s", pongTraceThreadName ? pongTraceThreadName : "Thread");
+    atomic_store_explicit(&buffer->ready, true, memory_order_release);     // Publish only the finished slot to pongTraceWrite
+    pongTraceUntraced = false;
+    pongTraceLocal = buffer;
+    return buffer;
+}
+static inline PongTraceZone pongTraceBegin(const char* name) {
+    return (PongTraceZone){ name, pongTraceOn ? pongTraceNow() : 0 };
+}
+static inline void pongTraceEnd(PongTraceZone* zone) {
+    if (!pongTraceOn) return;
+    int64_t endNs = pongTraceNow();
+    PongTraceBuffer* buffer = pongTraceLocal ? pongTraceLocal : pongTraceUntraced ? NULL : pongTraceRegister();
+    if (!buffer) {
+        atomic_fetch_add_explicit(&pongTraceLost, 1, memory_order_relaxed);
+        return;
+    }
+    long count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+    buffer->events[count % PONG_TRACE_EVENTS] = (PongTraceEvent){ zone->name, zone->startNs, endNs - zone->startNs };
+    atomic_store_explicit(&buffer->count, count + 1, memory_order_release);     // The exporter reads up to here
+}
+#define PONG_TRACE_JOIN(a, b) a##b
+#define PONG_TRACE_NAME(line) PONG_TRACE_JOIN(pongZone, line)
+#define PONG_ZONE(name) PongTraceZone PONG_TRACE_NAME(__LINE__) __attribute__((cleanup(pongTraceEnd))) = pongTraceBegin(name)     // Until the end of the block
+static inline bool pongTraceWrite(const char* path) { // Any thread, any time: every buffer's events so far, as Chrome trace JSON
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Cannot write trace %s\n", path);
+        return false;
+    }
+    int pid = getpid();
+    long written = 0;
+    int claimed = atomic_load(&pongTraceThreadCount), threads = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"PingPong\"}}", pid);
+    for (int t = 0; t < claimed && t < PONG_TRACE_MAX_THREADS; t++) {
+        PongTraceBuffer* buffer = &pongTraceBuffers[t];
+        if (!atomic_load_explicit(&buffer->ready, memory_order_acquire)) continue;     // Still being set up, or out of memory
+        threads++;
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", pid, buffer->tid, buffer->name);
+        long end = atomic_load_explicit(&buffer->count, memory_order_acquire);
+        long start = end > PONG_TRACE_EVENTS ? end - PONG_TRACE_EVENTS + PONG_TRACE_SLACK : 0;
+        for (long n = start; n < end; n++) {
+            const PongTraceEvent* event = &buffer->events[n % PONG_TRACE_EVENTS];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d}", event->name,
+                    (long long)(event->startNs / 1000), (long long)(event->startNs % 1000),
+                    (long long)(event->durationNs / 1000), (long long)(event->durationNs % 1000), pid, buffer->tid);
+            written++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = fclose(file) == 0;
+    printf("Trace: %ld zones from %d threads written to %s%s\n", written, threads, path,
+           atomic_load(&pongTraceLost) ? ", some threads over the limit were not traced" : "");
+    return ok;
+}
+#endif
@@ -0,0 +1,87 @@
+#ifndef PONG_VIDEO_H // Clip writers for match recordings (PingPong.c --record, rerender.c)
+#define PONG_VIDEO_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#define PONG_VIDEO_FPS 60
+typedef enum { VIDEO_Y4M, VIDEO_RLE } VideoFormat;
+typedef struct {
+    FILE* file;
+    VideoFormat format;
+    int width, height;               // Even, for 4:2:0 chroma
+    unsigned char* buffer;           // Y4M: Y, U and V planes; RLE: encoded runs
+    long frames;
+    long bytes;
+} VideoWriter;
+static inline bool pongVideoOpen(VideoWriter* writer, const char* path, int width, int height) { // .y4m is raw YUV, anything else the RLE format
+    size_t length = strlen(path);
+    writer->format = (length >= 4 && strcmp(path + length - 4, ".y4m") == 0) ? VIDEO_Y4M : VIDEO_RLE;
+    writer->width = width & ~1;
+    writer->height = height & ~1;
+    writer->frames = 0;
+    writer->file = fopen(path, "wb");
+    if (!writer->file) return false;
+    size_t pixels = (size_t)writer->width * writer->height;
+    writer->buffer = malloc(writer->format == VIDEO_Y4M ? pixels * 3 / 2 : pixels * 4 + 4);     // RLE worst case: one run per pixel
+    if (writer->format == VIDEO_Y4M) {
+        writer->bytes = fprintf(writer->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", writer->width, writer->height, PONG_VIDEO_FPS);
+    } else {                         // Each frame: uint32 byte count, then (length, r, g, b) runs in raster order
+        writer->bytes = fprintf(writer->file, "PONGRLE1 %d %d %d\n", writer->width, writer->height, PONG_VIDEO_FPS);
+    }
+    return true;
+}
+static inline void pongVideoWrite(VideoWriter* writer, const unsigned char* rgba, int stride, bool bottomUp) { // One RGBA frame
+    int w = writer->width, h = writer->height;
+    if (writer->format == VIDEO_Y4M) {
+        unsigned char *yPlane = writer->buffer, *uPlane = yPlane + w * h, *vPlane = uPlane + (w / 2) * (h / 2);
+        for (int y = 0; y < h; y += 2) {
+            const unsigned char* rows[2] = { rgba + (size_t)(bottomUp ? h - 1 - y : y) * stride,
+                                             rgba + (size_t)(bottomUp ? h - 2 - y : y + 1) * stride };
+            for (int x = 0; x < w; x += 2) {
+                int rSum = 0, gSum = 0, bSum = 0;
+                for (int k = 0; k < 4; k++) {
+                    const unsigned char* p = rows[k / 2] + (x + k % 2) * 4;
+                    yPlane[(y + k / 2) * w + x + k % 2] = (77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8;     // BT.601 full range
+                    rSum += p[0];
+                    gSum += p[1];
+                    bSum += p[2];
+                }
+                int u = 128 + ((-43 * rSum - 85 * gSum + 128 * bSum) >> 10), v = 128 + ((128 * rSum - 107 * gSum - 21 * bSum) >> 10);
+                uPlane[(y / 2) * (w / 2) + x / 2] = u < 0 ? 0 : u > 255 ? 255 : u;
+                vPlane[(y / 2) * (w / 2) + x / 2] = v < 0 ? 0 : v > 255 ? 255 : v;
+            }
+        }
+        fputs("FRAME\n", writer->file);
+        fwrite(writer->buffer, 1, (size_t)w * h * 3 / 2, writer->file);
+        writer->bytes += 6 + (long)w * h * 3 / 2;
+    } else {
+        unsigned char* out = writer->buffer + 4;
+        for (int y = 0; y < h; y++) {
+            const unsigned char* row = rgba + (size_t)(bottomUp ? h - 1 - y : y) * stride;
+            for (int x = 0; x < w; ) {
+                const unsigned char* p = row + x * 4;
+                int run = 1;
+                while (x + run < w && run < 255 && memcmp(row + (x + run) * 4, p, 3) == 0) run++;
+                *out++ = run;
+                *out++ = p[0];
+                *out++ = p[1];
+                *out++ = p[2];
+                x += run;
+            }
+        }
+        uint32_t size = out - writer->buffer - 4;
+        memcpy(writer->buffer, &size, 4);
+        fwrite(writer->buffer, 1, size + 4, writer->file);
+        writer->bytes += size + 4;
+    }
+    writer->frames++;
+}
+static inline void pongVideoClose(VideoWriter* writer) {
+    if (writer->file) fclose(writer->file);
+    free(writer->buffer);
+    writer->file = NULL;
+    writer->buffer = NULL;
+}
+#endif
@@ -0,0 +1,58 @@
+#include <stdio.h> // Example external bot for PingPong.c --bot-left/--bot-right: gcc -O2 pongbot.c -o pongbot -lm
+#include <stdlib.h>
+#include <string.h>
+#include "pong_sim.h"
+#include "pong_bot.h"
+bool readFully(int fd, void* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = read(fd, (char*)buffer + done, size - done);
+        if (got <= 0) return false;
+        done += got;
+    }
+    return true;
+}
+float decide(const BotStateMessage* state, bool predict) { // Move toward where the ball will cross this bot's paddle
+    float faceX = state->side == BOT_SIDE_LEFT ? PADDLE_WIDTH : SCREEN_WIDTH - PADDLE_WIDTH;
+    bool incoming = state->side == BOT_SIDE_LEFT ? state->ballVelocityX < 0 : state->ballVelocityX > 0;
+    float targetY = SCREEN_HEIGHT / 2;
+    if (incoming) {
+        targetY = state->ballY;
+        if (predict) {
+            float predictedY = state->ballY + state->ballVelocityY * (faceX - state->ballX) / state->ballVelocityX;
+            while (predictedY < 0 || predictedY > SCREEN_HEIGHT) {
+                if (predictedY < 0) predictedY = -predictedY;
+                if (predictedY > SCREEN_HEIGHT) predictedY = 2 * SCREEN_HEIGHT - predictedY;
+            }
+            targetY = predictedY;
+        }
+    }
+    float offset = targetY - (state->paddleY + PADDLE_HEIGHT / 2);
+    return fmaxf(-PADDLE_SPEED, fminf(PADDLE_SPEED, offset));
+}
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    bool predict = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--predict") == 0) predict = true;
+        else path = argv[i];
+    }
+    if (!path) {
+        printf("Usage: %s <socket path> [--predict]\n", argv[0]);
+        return 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    while (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) usleep(100000);     // Game may start later
+    BotStateMessage state;
+    long states = 0;
+    while (readFully(fd, &state, sizeof(state))) {
+        BotCommand command = { state.tick, (state.flags & (BOT_FLAG_PAUSED | BOT_FLAG_GAME_OVER)) ? 0.0f : decide(&state, predict) };
+        if (write(fd, &command, sizeof(command)) != sizeof(command)) break;
+        states++;
+    }
+    printf("Game closed the connection after %ld states\n", states);
+    close(fd);
+    return 0;
+}
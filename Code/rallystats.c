@@ -0,0 +1,108 @@
+#include <stdio.h> // Reader for PingPong.c --analytics rally logs: gcc -O2 rallystats.c -o rallystats
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "pong_sim.h"
+#include "pong_rally.h"
+#define MAX_RALLY_LENGTH 1000
+#define HIT_BINS 10
+#define COLUMN(name) (1u << columnIndex(name))
+int columnIndex(const char* name) {
+    for (int c = 0; c < RALLY_COLUMN_COUNT; c++) {
+        if (strcmp(rallyColumns[c].name, name) == 0) return c;
+    }
+    return 31;
+}
+void printCsv(FILE* file) {
+    static RallyEvent events[RALLY_BLOCK_ROWS];
+    printf("time_ns,rally,rally_hits,hit_position,bounce_angle,speed,x,y,type,level,left_score,right_score\n");
+    uint32_t rows;
+    while ((rows = rallyReadBlock(file, events, ~0u)) > 0) {
+        for (uint32_t r = 0; r < rows; r++) {
+            const RallyEvent* e = &events[r];
+            printf("%llu,%u,%u,%.4f,%.4f,%.3f,%.1f,%.1f,%s,%u,%u,%u\n", (unsigned long long)e->timeNs, e->rally, e->rallyHits,
+                   e->hitPosition, e->bounceAngle, e->speed, e->x, e->y,
+                   rallyTypeName(e->type), e->level, e->leftScore, e->rightScore);
+        }
+    }
+}
+void printSummary(FILE* file) { // Reads only the columns it needs
+    static RallyEvent events[RALLY_BLOCK_ROWS];
+    static long rallyLengths[MAX_RALLY_LENGTH + 1];
+    long typeCounts[RALLY_TYPE_COUNT] = {0}, hitBins[HIT_BINS] = {0}, hitsByLevel[PONG_MAX_LEVELS + 1] = {0}, blocks = 0, total = 0, rallies = 0;
+    double speedByLevel[PONG_MAX_LEVELS + 1] = {0}, rallyHitSum = 0;
+    uint32_t longestRally = 0;
+    uint32_t mask = COLUMN("rally_hits") | COLUMN("hit_position") | COLUMN("speed") | COLUMN("type") | COLUMN("level");
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t rows;
+    while ((rows = rallyReadBlock(file, events, mask)) > 0) {
+        blocks++;
+        total += rows;
+        for (uint32_t r = 0; r < rows; r++) {
+            const RallyEvent* e = &events[r];
+            if (e->type >= RALLY_TYPE_COUNT) continue;
+            typeCounts[e->type]++;
+            if (e->type == RALLY_LEFT_HIT || e->type == RALLY_RIGHT_HIT) {
+                int bin = (int)(e->hitPosition * HIT_BINS);
+                hitBins[bin < 0 ? 0 : bin >= HIT_BINS ? HIT_BINS - 1 : bin]++;
+                int level = e->level <= PONG_MAX_LEVELS ? e->level : 0;     // Levels are numbered from 1, as many as a --levels file defines
+                speedByLevel[level] += e->speed;
+                hitsByLevel[level]++;
+            } else if (e->type == RALLY_LEFT_SCORED || e->type == RALLY_RIGHT_SCORED) {
+                rallies++;
+                rallyHitSum += e->rallyHits;
+                rallyLengths[e->rallyHits < MAX_RALLY_LENGTH ? e->rallyHits : MAX_RALLY_LENGTH]++;
+                if (e->rallyHits > longestRally) longestRally = e->rallyHits;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%ld events in %ld blocks, read in %.3f s (%.1f M events/s)\n", total, blocks, seconds, total / (seconds > 0 ? seconds : 1e-9) / 1e6);
+    for (int t = 0; t < RALLY_TYPE_COUNT; t++) printf("  %-13s %ld\n", rallyTypeName(t), typeCounts[t]);
+    if (rallies > 0) {
+        long seen = 0;
+        int p50 = -1, p90 = -1;
+        for (int i = 0; i <= MAX_RALLY_LENGTH; i++) {
+            seen += rallyLengths[i];
+            if (p50 < 0 && seen * 2 >= rallies) p50 = i;
+            if (p90 < 0 && seen * 10 >= rallies * 9) p90 = i;
+        }
+        printf("Rallies: %ld, paddle hits per rally: mean %.2f, p50 %d, p90 %d, max %u\n", rallies, rallyHitSum / rallies, p50, p90, longestRally);
+    }
+    for (int level = 1; level <= PONG_MAX_LEVELS; level++) {
+        if (hitsByLevel[level] > 0) printf("Level %d: %ld paddle hits, mean speed after hit %.2f\n", level, hitsByLevel[level], speedByLevel[level] / hitsByLevel[level]);
+    }
+    long hits = typeCounts[RALLY_LEFT_HIT] + typeCounts[RALLY_RIGHT_HIT];
+    if (hits > 0) {
+        printf("Hit position on the paddle (top to bottom):\n");
+        for (int b = 0; b < HIT_BINS; b++) {
+            printf("  %.1f-%.1f %5.1f%% ", (float)b / HIT_BINS, (float)(b + 1) / HIT_BINS, 100.0 * hitBins[b] / hits);
+            for (int i = 0; i < 50 * hitBins[b] / hits; i++) putchar('#');
+            putchar('\n');
+        }
+    }
+}
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    bool csv = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else path = argv[i];
+    }
+    if (!path) {
+        printf("Usage: %s <analytics file> [--csv]\n", argv[0]);
+        return 1;
+    }
+    FILE* file = fopen(path, "rb");
+    if (!file || !rallyReadHeader(file)) {
+        printf("%s is not a rally log from this version of PingPong.c\n", path);
+        return 1;
+    }
+    if (csv) printCsv(file);
+    else printSummary(file);
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <stdio.h> // Headless re-render of a recorded match: gcc -O2 rerender.c -o rerender -lm
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pong_sim.h"
+#include "pong_levels.h"
+#include "pong_video.h"
+#include "pong_snapshot.h"
+#include "pong_glyphs.h"
+int width, height;
+float scale = 0.5f;
+unsigned char* pixels;              // RGBA, top-down
+const Color WHITE_RGB = { 255, 255, 255, 255 };
+void blendRect(float x0, float y0, float x1, float y1, Color color, float alpha) { // Scene units, clipped to the frame
+    int px0 = x0 * scale, py0 = y0 * scale, px1 = x1 * scale, py1 = y1 * scale;
+    if (px0 < 0) px0 = 0;
+    if (py0 < 0) py0 = 0;
+    if (px1 > width) px1 = width;
+    if (py1 > height) py1 = height;
+    for (int y = py0; y < py1; y++) {
+        unsigned char* p = pixels + ((size_t)y * width + px0) * 4;
+        for (int x = px0; x < px1; x++, p += 4) {
+            p[0] += (color.r - p[0]) * alpha;
+            p[1] += (color.g - p[1]) * alpha;
+            p[2] += (color.b - p[2]) * alpha;
+        }
+    }
+}
+void blendCircle(float cx, float cy, float radius, Color color, float alpha) {
+    int x0 = (cx - radius) * scale, x1 = (cx + radius) * scale + 1, y0 = (cy - radius) * scale, y1 = (cy + radius) * scale + 1;
+    float r2 = radius * scale * radius * scale;
+    for (int y = y0 < 0 ? 0 : y0; y < y1 && y < height; y++) {
+        for (int x = x0 < 0 ? 0 : x0; x < x1 && x < width; x++) {
+            float dx = x + 0.5f - cx * scale, dy = y + 0.5f - cy * scale;
+            if (dx * dx + dy * dy > r2) continue;
+            unsigned char* p = pixels + ((size_t)y * width + x) * 4;
+            p[0] += (color.r - p[0]) * alpha;
+            p[1] += (color.g - p[1]) * alpha;
+            p[2] += (color.b - p[2]) * alpha;
+        }
+    }
+}
+void drawNumber(int value, float x, float y, float size) { // size: scene units per glyph cell
+    char text[16];
+    sprintf(text, "%d", value);
+    for (int i = 0; text[i]; i++) {
+        PongGlyph glyph = pongGlyph(text[i] - '0');
+        for (int r = 0; r < glyph.count; r++) {
+            PongGlyphRun run = glyph.runs[r];
+            blendRect(x + run.column * size, y + run.row * size, x + (run.column + run.length) * size, y + (run.row + 1) * size,
+                      WHITE_RGB, 1.0f);
+        }
+        x += 4 * size;
+    }
+}
+void renderMatch(const PongMatch* match) { // Same scene as drawGame(), without the text overlays
+    const PongTheme* theme = pongTheme(match->level);
+    Color bg = theme->background;
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        pixels[i * 4] = bg.r;
+        pixels[i * 4 + 1] = bg.g;
+        pixels[i * 4 + 2] = bg.b;
+        pixels[i * 4 + 3] = 255;
+    }
+    for (int y = 0; y < SCREEN_HEIGHT; y += 20) {
+        blendRect(SCREEN_WIDTH / 2 - 5, y, SCREEN_WIDTH / 2 + 5, y + 10, WHITE_RGB, 0.5f);
+    }
+    blendRect(0, match->leftPaddleY, PADDLE_WIDTH, match->leftPaddleY + PADDLE_HEIGHT, theme->paddle, 1.0f);
+    blendRect(SCREEN_WIDTH - PADDLE_WIDTH, match->rightPaddleY, SCREEN_WIDTH, match->rightPaddleY + PADDLE_HEIGHT, theme->paddle, 1.0f);
+    for (int i = 0; i < theme->trailLength; i++) {
+        blendCircle(match->ballPosition.x - match->ballVelocity.x * (i * 1.5f), match->ballPosition.y - match->ballVelocity.y * (i * 1.5f),
+                    theme->trailRadius[i], theme->ball, 0.3f - (i * 0.03f));
+    }
+    blendCircle(match->ballPosition.x, match->ballPosition.y, BALL_RADIUS, theme->ball, 1.0f);
+    drawNumber(match->leftScore, SCREEN_WIDTH / 4, 30, 12);
+    drawNumber(match->rightScore, 3 * SCREEN_WIDTH / 4 - 20, 30, 12);
+}
+int main(int argc, char* argv[]) {
+    const char* statesPath = NULL;
+    const char* outputPath = NULL;
+    const char* levelsPath = NULL;      // The recording game's --levels file, for its colors
+    long fromFrame = 0;                 // Fixed-size records, so starting later is one seek
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) scale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) fromFrame = atol(argv[++i]);
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];
+        else if (!statesPath) statesPath = argv[i];
+        else if (!outputPath) outputPath = argv[i];
+    }
+    if (!statesPath || !outputPath || scale <= 0.0f || scale > 4.0f) {
+        printf("Usage: %s <clip.states> <output.y4m|output.rle> [--scale 0.5] [--from frame] [--levels file]\n", argv[0]);
+        return 1;
+    }
+    if (!pongLoadLevels(levelsPath)) return 1;
+    FILE* states = fopen(statesPath, "rb");
+    PongSnapshotHeader header, expected = pongSnapshotHeader(PONG_SNAPSHOT_MATCH, PONG_MATCH_SNAPSHOT_VERSION, sizeof(PongMatchSnapshot));
+    if (!states || fread(&header, sizeof(header), 1, states) != 1 || memcmp(&header, &expected, sizeof(header)) != 0) {
+        printf("%s is not a recorded states log of this version\n", statesPath);
+        return 1;
+    }
+    if (fseek(states, (long)sizeof(header) + fromFrame * (long)sizeof(PongMatchSnapshot), SEEK_SET) != 0) {
+        printf("Cannot seek to frame %ld\n", fromFrame);
+        return 1;
+    }
+    width = (int)(SCREEN_WIDTH * scale) & ~1;
+    height = (int)(SCREEN_HEIGHT * scale) & ~1;
+    pixels = malloc((size_t)width * height * 4);
+    VideoWriter writer;
+    if (!pongVideoOpen(&writer, outputPath, width, height)) {
+        printf("Cannot write %s\n", outputPath);
+        return 1;
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    PongMatchSnapshot snapshot;
+    while (fread(&snapshot, sizeof(PongMatchSnapshot), 1, states) == 1) {
+        renderMatch(&snapshot.match);
+        pongVideoWrite(&writer, pixels, width * 4, false);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%ld frames at %dx%d in %.2f s: %.0f frames/s, %.1fx real time, %.1f MB written\n", writer.frames, width, height,
+           seconds, writer.frames / seconds, writer.frames / seconds / PONG_VIDEO_FPS, writer.bytes / 1e6);
+    pongVideoClose(&writer);
+    fclose(states);
+    free(pixels);
+    return 0;
+}
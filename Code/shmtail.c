@@ -0,0 +1,85 @@
+#define _GNU_SOURCE     // clock_nanosleep
+#include <stdio.h> // Tails PingPong.c --export-state at 1 kHz: gcc -O2 shmtail.c -o shmtail -lrt
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "pong_shm.h"
+volatile sig_atomic_t stopRequested = 0;
+void onSignal(int signal) {
+    stopRequested = 1;
+}
+int64_t nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+int main(int argc, char* argv[]) {
+    const char* name = PONG_SHM_NAME;
+    int rateHz = 1000;
+    double seconds = 0.0;            // 0 = until Ctrl+C
+    bool quiet = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) name = argv[++i];
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) rateHz = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--quiet") == 0) quiet = true;
+        else {
+            printf("Usage: %s [--name /pingpong-state] [--hz 1000] [--seconds N] [--quiet]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rateHz < 1) rateHz = 1;
+    signal(SIGINT, onSignal);
+    const PongShmSegment* segment;
+    while (!(segment = pongShmOpen(name))) {     // The game may not be running yet
+        if (stopRequested) return 1;
+        printf("Waiting for %s (start PingPong with --export-state)...\n", name);
+        sleep(1);
+    }
+    printf("Reading %s from pid %u at %d Hz\n", name, segment->writerPid, rateHz);
+    long reads = 0, retries = 0, failed = 0, newTicks = 0, skippedTicks = 0;
+    int64_t maxReadNs = 0, maxAgeNs = 0, start = nowNs();
+    uint64_t lastTick = 0;
+    bool haveTick = false;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!stopRequested && (seconds <= 0.0 || nowNs() - start < seconds * 1e9)) {
+        next.tv_nsec += 1000000000 / rateHz;
+        if (next.tv_nsec >= 1000000000) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        PongLiveState state;
+        int64_t before = nowNs();
+        int used = pongShmRead(segment, &state, 100);
+        int64_t after = nowNs();
+        reads++;
+        if (after - before > maxReadNs) maxReadNs = after - before;
+        if (used < 0) {
+            failed++;
+            continue;
+        }
+        retries += used;
+        if (haveTick && state.tick == lastTick) continue;
+        if (haveTick && state.tick > lastTick + 1) skippedTicks += state.tick - lastTick - 1;
+        if (after - state.timeNs > maxAgeNs && state.timeNs > 0) maxAgeNs = after - state.timeNs;
+        lastTick = state.tick;
+        haveTick = true;
+        newTicks++;
+        if (!quiet) {
+            printf("\rtick %8llu  ball (%7.1f, %6.1f) vel (%6.2f, %6.2f)  paddles %5.1f %5.1f  %2d-%-2d  L%d %s%s%s   ",
+                   (unsigned long long)state.tick, state.ballX, state.ballY, state.ballVelocityX, state.ballVelocityY,
+                   state.leftPaddleY, state.rightPaddleY, state.leftScore, state.rightScore, state.level,
+                   !state.modeSelected ? "menu" : state.twoPlayer ? "2P" : "1P", state.paused ? " paused" : "",
+                   state.gameOver ? " game over" : "");
+            fflush(stdout);
+        }
+    }
+    printf("\n%ld reads, %ld new ticks (%ld missed), %ld retries, %ld torn after 100 retries\n", reads, newTicks, skippedTicks,
+           retries, failed);
+    printf("Max read time %.1f us, max state age when first seen %.2f ms\n", maxReadNs / 1e3, maxAgeNs / 1e6);
+    pongShmClose(segment);
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include <stdio.h> // Many live matches in one window: gcc -O2 tables.c -o tables -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <raylib.h>
+#include "pong_sim.h"
+#include "pong_levels.h"
+#include "pong_shm.h"     // Live tables read PingPong.c --export-state segments, local tables publish the same way
+#include "pong_glyphs.h"
+#define MAX_TABLES 64
+#define WINDOW_WIDTH 1280
+#define WINDOW_HEIGHT 800
+#define TABLE_GAP 2                  // Pixels between two tables
+#define REMATCH_TICKS 180            // A finished local table starts its next match after 3 seconds
+#define RECONNECT_FRAMES 60          // How often a live table whose game is not running looks for it again
+typedef struct {                     // A table as it appears on screen, in window pixels: redrawn only when this changes
+    short ballX, ballY, leftPaddleY, rightPaddleY;
+    unsigned char leftScore, rightScore, level, flags;
+} TableKey;
+enum { TABLE_PAUSED = 1, TABLE_GAME_OVER = 2, TABLE_OFFLINE = 4 };
+typedef struct {
+    const char* shmName;             // Live game, NULL for a local CPU vs CPU match
+    const PongShmSegment* live;
+    PongShmSegment local;            // Local matches are published through the same seqlock as --export-state
+    PongMatch match;                 // Sim thread only from here
+    PongAiController leftAi, rightAi;     // Both CPUs are stepped by the sim thread, no thread of their own
+    int overTicks;
+    uint64_t ticks;
+    TableKey drawn;                  // Main thread only: what the grid texture holds for this table
+    bool drawnValid;
+} Table;
+Table tables[MAX_TABLES];
+int tableCount;
+int columns, rows;
+float tableWidth, tableHeight, tableScale;     // Window pixels per table, window pixels per scene unit
+PongGlyph digits[10];                // Built once, every score on every table is drawn from these runs
+atomic_bool simDone = false;
+long quadsDrawn;                     // All of them go through one texture and one primitive mode, so rlgl batches them
+void startMatch(Table* table, int level, uint64_t seed) {
+    pongInitMatch(&table->match, level, seed);
+    pongAiInit(&table->leftAi, true, seed ^ 0xA5A5A5A5A5A5A5A5ull);
+    pongAiInit(&table->rightAi, false, seed ^ 0x5A5A5A5A5A5A5A5Aull);
+    table->overTicks = 0;
+}
+void stepTable(Table* table, const struct timespec* now) {
+    PongMatch* match = &table->match;
+    if (match->gameOver) {
+        if (++table->overTicks >= REMATCH_TICKS) startMatch(table, match->level, pongRandomNext(&table->leftAi.rng));
+    } else {
+        float leftMove = pongAiTick(&table->leftAi, match);     // Both see the same tick
+        match->rightPaddleY += pongAiTick(&table->rightAi, match);
+        match->leftPaddleY += leftMove;
+        pongClampPaddle(&match->leftPaddleY);
+        pongClampPaddle(&match->rightPaddleY);
+        pongStepBall(match);
+    }
+    PongLiveState state = {
+        .tick = ++table->ticks,
+        .timeNs = (int64_t)now->tv_sec * 1000000000 + now->tv_nsec,
+        .ballX = match->ballPosition.x, .ballY = match->ballPosition.y,
+        .ballVelocityX = match->ballVelocity.x, .ballVelocityY = match->ballVelocity.y,
+        .leftPaddleY = match->leftPaddleY, .rightPaddleY = match->rightPaddleY,
+        .leftScore = match->leftScore, .rightScore = match->rightScore,
+        .level = match->level,
+        .gameOver = match->gameOver,
+        .modeSelected = 1
+    };
+    pongShmPublish(&table->local, &state);
+}
+void* simThreadFunc(void* arg) { // Steps every local table once per ball tick
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!atomic_load(&simDone)) {
+        for (int i = 0; i < tableCount; i++) {
+            if (!tables[i].shmName) stepTable(&tables[i], &next);
+        }
+        next.tv_nsec += AI_THINK_MS * 1000000L;     // Absolute deadlines: 64 tables of work do not stretch the tick
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+bool readTable(Table* table, long frame, PongLiveState* state) { // Latest state; false while a live game is not running
+    if (!table->shmName) return pongShmRead(&table->local, state, 8) >= 0;
+    if (!table->live && frame % RECONNECT_FRAMES == 0) table->live = pongShmOpen(table->shmName);
+    return table->live && pongShmRead(table->live, state, 8) >= 0;
+}
+TableKey tableKey(const PongLiveState* state, bool online) {
+    TableKey key = {0};              // Zeroed, so padding compares equal too
+    if (!online) {
+        key.flags = TABLE_OFFLINE;
+        return key;
+    }
+    key.ballX = (short)(state->ballX * tableScale);
+    key.ballY = (short)(state->ballY * tableScale);
+    key.leftPaddleY = (short)(state->leftPaddleY * tableScale);
+    key.rightPaddleY = (short)(state->rightPaddleY * tableScale);
+    key.leftScore = (unsigned char)state->leftScore;
+    key.rightScore = (unsigned char)state->rightScore;
+    key.level = (unsigned char)state->level;
+    key.flags = (state->paused ? TABLE_PAUSED : 0) | (state->gameOver ? TABLE_GAME_OVER : 0);
+    return key;
+}
+void drawQuad(float x, float y, float width, float height, Color color) {
+    DrawRectangleRec((Rectangle){ x, y, width, height }, color);
+    quadsDrawn++;
+}
+void drawScore(int value, float x, float y, float cell) {
+    char text[8];
+    snprintf(text, sizeof(text), "%d", value);
+    for (int i = 0; text[i]; i++, x += 4 * cell) {
+        const PongGlyph* glyph = &digits[text[i] - '0'];
+        for (int r = 0; r < glyph->count; r++) {
+            drawQuad(x + glyph->runs[r].column * cell, y + glyph->runs[r].row * cell, glyph->runs[r].length * cell, cell, WHITE);
+        }
+    }
+}
+void drawTable(const TableKey* key, float x, float y) { // Rectangles only: the ball is square so the whole grid stays one batch
+    if (key->flags & TABLE_OFFLINE) {
+        drawQuad(x, y, tableWidth, tableHeight, (Color){30, 30, 30, 255});
+        return;
+    }
+    const PongTheme* theme = pongTheme(key->level);
+    Color background = theme->background;
+    drawQuad(x, y, tableWidth, tableHeight, background);     // Also erases the previous frame of this table
+    Color line = { (background.r + 255) / 2, (background.g + 255) / 2, (background.b + 255) / 2, 255 };     // Half white, blended here so the texture stays opaque
+    float dash = 10 * tableScale;
+    for (float dashY = 0; dashY < tableHeight; dashY += 2 * dash) {
+        drawQuad(x + tableWidth / 2 - dash / 2, y + dashY, dash, dash, line);
+    }
+    drawQuad(x, y + key->leftPaddleY, PADDLE_WIDTH * tableScale, PADDLE_HEIGHT * tableScale, theme->paddle);
+    drawQuad(x + tableWidth - PADDLE_WIDTH * tableScale, y + key->rightPaddleY, PADDLE_WIDTH * tableScale,
+             PADDLE_HEIGHT * tableScale, theme->paddle);
+    float ball = BALL_RADIUS * tableScale;
+    drawQuad(x + key->ballX - ball, y + key->ballY - ball, 2 * ball, 2 * ball, theme->ball);
+    drawScore(key->leftScore, x + tableWidth / 4, y + 30 * tableScale, 12 * tableScale);
+    drawScore(key->rightScore, x + 3 * tableWidth / 4 - 20 * tableScale, y + 30 * tableScale, 12 * tableScale);
+    if (key->flags & (TABLE_PAUSED | TABLE_GAME_OVER)) drawQuad(x, y, tableWidth, tableHeight, Fade(BLACK, 0.5f));
+}
+int compareFloats(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+int main(int argc, char* argv[]) {
+    int localTables = -1;
+    int level = 0;                   // 0: every level in turn across the grid
+    uint64_t seed = (uint64_t)time(NULL);
+    double seconds = 0;
+    bool showHud = true;
+    const char* levelsPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tables") == 0 && i + 1 < argc) localTables = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) level = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--no-hud") == 0) showHud = false;
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];
+        else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc && tableCount < MAX_TABLES) tables[tableCount++].shmName = argv[++i];
+        else {
+            printf("Usage: %s [--tables 16] [--level n] [--seed n] [--shm /pingpong-state]... [--seconds n] [--no-hud] [--levels file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!pongLoadLevels(levelsPath)) return 1;
+    if (localTables < 0) localTables = tableCount > 0 ? 0 : 16;
+    if (localTables > MAX_TABLES - tableCount) localTables = MAX_TABLES - tableCount;
+    for (int i = 0; i < localTables; i++, tableCount++) {
+        startMatch(&tables[tableCount], level > 0 ? level : 1 + i % pongLevelCount, seed + i);
+    }
+    if (tableCount == 0) {
+        printf("No tables to show\n");
+        return 1;
+    }
+    for (int d = 0; d < 10; d++) digits[d] = pongGlyph(d);
+    columns = (int)ceilf(sqrtf((float)tableCount));      // Tables have the window's aspect, so a square grid fills it best
+    rows = (tableCount + columns - 1) / columns;
+    tableScale = fminf(((float)WINDOW_WIDTH / columns - TABLE_GAP) / SCREEN_WIDTH, ((float)WINDOW_HEIGHT / rows - TABLE_GAP) / SCREEN_HEIGHT);
+    tableWidth = SCREEN_WIDTH * tableScale;
+    tableHeight = SCREEN_HEIGHT * tableScale;
+    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Ping Pong Tables");
+    SetTargetFPS(60);
+    RenderTexture2D grid = LoadRenderTexture(WINDOW_WIDTH, WINDOW_HEIGHT);     // Holds every table; unchanged tables are not redrawn
+    BeginTextureMode(grid);
+    ClearBackground(BLACK);
+    EndTextureMode();
+    pthread_t simThread;
+    pthread_create(&simThread, NULL, simThreadFunc, NULL);
+    long frames = 0, tablesRedrawn = 0, lateFrames = 0, frameCapacity = 3600;
+    float* frameMs = malloc(frameCapacity * sizeof(float));     // Time to build and submit each frame, vsync wait excluded
+    double start = GetTime();
+    while (!WindowShouldClose() && (seconds <= 0 || GetTime() - start < seconds)) {
+        double frameStart = GetTime();
+        int redrawn = 0;
+        BeginTextureMode(grid);
+        for (int i = 0; i < tableCount; i++) {
+            PongLiveState state;
+            bool online = readTable(&tables[i], frames, &state);
+            TableKey key = tableKey(&state, online);
+            if (tables[i].drawnValid && memcmp(&key, &tables[i].drawn, sizeof(key)) == 0) continue;
+            float cellWidth = (float)WINDOW_WIDTH / columns, cellHeight = (float)WINDOW_HEIGHT / rows;
+            drawTable(&key, (i % columns) * cellWidth + (cellWidth - tableWidth) / 2, (i / columns) * cellHeight + (cellHeight - tableHeight) / 2);
+            tables[i].drawn = key;
+            tables[i].drawnValid = true;
+            redrawn++;
+        }
+        EndTextureMode();
+        BeginDrawing();
+        DrawTextureRec(grid.texture, (Rectangle){ 0, 0, WINDOW_WIDTH, -WINDOW_HEIGHT }, (Vector2){ 0, 0 }, WHITE);     // Render textures are stored upside down
+        if (showHud) DrawText(TextFormat("%d tables  %d FPS  %d redrawn", tableCount, GetFPS(), redrawn), 8, 8, 20, GREEN);
+        if (frames == frameCapacity) frameMs = realloc(frameMs, (frameCapacity *= 2) * sizeof(float));
+        frameMs[frames++] = (float)((GetTime() - frameStart) * 1000.0);
+        tablesRedrawn += redrawn;
+        EndDrawing();
+        if (frames > 1 && GetFrameTime() > 1.5f / 60) lateFrames++;     // Missed the 60 FPS budget by more than half a frame
+    }
+    double elapsed = GetTime() - start;
+    atomic_store(&simDone, true);
+    pthread_join(simThread, NULL);
+    UnloadRenderTexture(grid);
+    CloseWindow();
+    for (int i = 0; i < tableCount; i++) {
+        if (tables[i].live) pongShmClose(tables[i].live);
+    }
+    if (frames > 0) {
+        qsort(frameMs, frames, sizeof(float), compareFloats);
+        printf("%d tables, %ld frames in %.1f s (%.1f FPS), %ld late\n", tableCount, frames, elapsed, frames / elapsed, lateFrames);
+        printf("Frame build time: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", frameMs[frames / 2], frameMs[frames * 99 / 100], frameMs[frames - 1]);
+        printf("Tables redrawn per frame: %.1f of %d, %.0f quads per frame\n", (double)tablesRedrawn / frames, tableCount, (double)quadsDrawn / frames);
+    }
+    free(frameMs);
+    return 0;
+}
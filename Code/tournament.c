@@ -0,0 +1,396 @@
+#include <stdio.h> // Headless bot tournament: gcc -O2 tournament.c -o tournament -lpthread -lm
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "pong_fixed.h"
+#define MAX_TICKS 100000            // About 28 minutes of play, a match still undecided then is scored as it stands
+#define BOOTSTRAP_SAMPLES 200
+#define MAX_BOTS 64                 // Field size; the Swiss standings and Elo samples are sized by it
+#define CONSOLE_CELL (SCREEN_HEIGHT / 24.0f)     // One row of the console build's 80x24 grid
+typedef struct {
+    int cooldown;                   // Ticks until the next decision
+    PongAiController ai;            // aiBot: PingPong.c's CPU, fed the bot's view every tick
+} BotState;
+typedef float (*BotFunc)(const PongMatch* view, int level, BotState* state, PongRng* rng);
+typedef struct {
+    const char* name;
+    BotFunc decide;                 // Plays the right paddle of view, returns this tick's paddle move
+    int level;
+} Bot;
+typedef struct {
+    int left, right;                // Indices into bots[]
+    uint64_t seed;
+    int leftScore, rightScore;
+    long ticks;
+    int paddleHits;
+    int longestRally;
+} MatchResult;
+float aiBot(const PongMatch* view, int level, BotState* state, PongRng* rng) { // PingPong.c's CPU at its own level, on its own RNG stream
+    state->ai.tuning = pongLevel(level);
+    return pongAiTick(&state->ai, view);
+}
+float consoleBot(const PongMatch* view, int level, BotState* state, PongRng* rng) { // aiPaddleThread from the console build
+    if (state->cooldown > 0) {
+        state->cooldown--;
+        return 0.0f;
+    }
+    state->cooldown = 150 / AI_THINK_MS - 1;     // Moves one cell every 0.15 seconds
+    float targetY = view->ballPosition.y - PADDLE_HEIGHT / 2;
+    if (pongRandomValue(rng, 0, 9) < 2) {  // 20% chance of moving randomly
+        targetY += (pongRandomValue(rng, 0, 4) - 2) * CONSOLE_CELL;
+    }
+    if (view->rightPaddleY < targetY - CONSOLE_CELL / 2) return CONSOLE_CELL;
+    if (view->rightPaddleY > targetY + CONSOLE_CELL / 2) return -CONSOLE_CELL;
+    return 0.0f;
+}
+float trackerBot(const PongMatch* view, int level, BotState* state, PongRng* rng) { // Holds the key towards the ball, like a perfect human
+    float center = view->rightPaddleY + PADDLE_HEIGHT / 2;
+    if (view->ballPosition.y < center - PADDLE_SPEED) return -PADDLE_SPEED;
+    if (view->ballPosition.y > center + PADDLE_SPEED) return PADDLE_SPEED;
+    return 0.0f;
+}
+const Bot builtinBots[] = {     // Add new bots here
+    {"ai-l1", aiBot, 1},
+    {"ai-l2", aiBot, 2},
+    {"ai-l3", aiBot, 3},
+    {"console", consoleBot, 0},
+    {"tracker", trackerBot, 0},
+};
+#define BUILTIN_BOT_COUNT (int)(sizeof(builtinBots) / sizeof(builtinBots[0]))
+Bot bots[MAX_BOTS];                 // The field: every built-in bot, or the --bots selection
+int botCount;
+int matchLevel = 1;                 // Physics level (ball speeds) for every match
+bool fixedEngine = false;           // --engine fixed: the ball runs on pong_fixed.h, bots still see and move in floats
+MatchResult* results;
+int resultCount, resultCapacity;
+atomic_int nextMatch;
+int batchEnd;
+void runMatch(MatchResult* result) {
+    PongMatch match;
+    PongFixedMatch fixed = {0};       // Only used with --engine fixed
+    if (fixedEngine) {
+        pongFixedInitMatch(&fixed, matchLevel, result->seed);
+        pongFixedToMatch(&fixed, &match);
+    } else {
+        pongInitMatch(&match, matchLevel, result->seed);
+    }
+    PongRng leftRng = { result->seed ^ 0xA5A5A5A5A5A5A5A5ull }, rightRng = { result->seed ^ 0x5A5A5A5A5A5A5A5Aull };
+    BotState leftState = {0}, rightState = {0};
+    pongAiInit(&leftState.ai, false, leftRng.state);     // The left bot's view is already mirrored
+    pongAiInit(&rightState.ai, false, rightRng.state);
+    const Bot* left = &bots[result->left];
+    const Bot* right = &bots[result->right];
+    int rally = 0;
+    result->ticks = 0;
+    result->paddleHits = 0;
+    result->longestRally = 0;
+    while (!match.gameOver && result->ticks < MAX_TICKS) {
+        PongMatch mirrored = pongMirror(&match);
+        float leftMove = left->decide(&mirrored, left->level, &leftState, &leftRng);
+        float rightMove = right->decide(&match, right->level, &rightState, &rightRng);
+        int events;
+        if (fixedEngine) {
+            fixed.leftPaddleY += pongFixedFromFloat(leftMove);
+            fixed.rightPaddleY += pongFixedFromFloat(rightMove);
+            pongFixedClampPaddle(&fixed.leftPaddleY);
+            pongFixedClampPaddle(&fixed.rightPaddleY);
+            events = pongFixedStepBall(&fixed);
+            pongFixedToMatch(&fixed, &match);     // The bots' view of the next tick
+        } else {
+            match.leftPaddleY += leftMove;
+            match.rightPaddleY += rightMove;
+            pongClampPaddle(&match.leftPaddleY);
+            pongClampPaddle(&match.rightPaddleY);
+            events = pongStepBall(&match);
+        }
+        result->ticks++;
+        if (events & (PONG_EVENT_LEFT_PADDLE | PONG_EVENT_RIGHT_PADDLE)) {
+            result->paddleHits++;
+            rally++;
+        }
+        if (events & (PONG_EVENT_LEFT_SCORED | PONG_EVENT_RIGHT_SCORED)) {
+            if (rally > result->longestRally) result->longestRally = rally;
+            rally = 0;
+        }
+    }
+    result->leftScore = match.leftScore;
+    result->rightScore = match.rightScore;
+}
+void* workerThread(void* arg) {
+    int index;
+    while ((index = atomic_fetch_add(&nextMatch, 1)) < batchEnd) {
+        runMatch(&results[index]);
+    }
+    return NULL;
+}
+void runBatch(int start, int threadCount) { // Plays results[start..resultCount) on all workers
+    pthread_t threads[256];
+    atomic_store(&nextMatch, start);
+    batchEnd = resultCount;
+    for (int i = 0; i < threadCount; i++) pthread_create(&threads[i], NULL, workerThread, NULL);
+    for (int i = 0; i < threadCount; i++) pthread_join(threads[i], NULL);
+}
+void scheduleMatch(int a, int b, PongRng* seeds) {
+    if (resultCount == resultCapacity) {
+        resultCapacity = resultCapacity ? resultCapacity * 2 : 1024;
+        results = realloc(results, resultCapacity * sizeof(MatchResult));
+    }
+    MatchResult* result = &results[resultCount++];
+    memset(result, 0, sizeof(*result));
+    result->left = a;
+    result->right = b;
+    result->seed = pongRandomNext(seeds);
+}
+double matchScore(const MatchResult* result, int side) { // 1 win, 0.5 draw, 0 loss for the left (side 0) or right player
+    if (result->leftScore == result->rightScore) return 0.5;
+    return ((result->leftScore > result->rightScore) == (side == 0)) ? 1.0 : 0.0;
+}
+void fitElo(const double* points, const double* games, int n, double* ratings) { // Maximum-likelihood Elo from pairwise totals
+    for (int i = 0; i < n; i++) ratings[i] = 0.0;
+    for (int iteration = 0; iteration < 500; iteration++) {
+        double change = 0.0;
+        for (int i = 0; i < n; i++) {
+            double expected = 0.0, actual = 0.0, slope = 0.0;
+            for (int j = 0; j < n; j++) {
+                if (games[i * n + j] == 0) continue;
+                double e = 1.0 / (1.0 + pow(10.0, (ratings[j] - ratings[i]) / 400.0));
+                expected += games[i * n + j] * e;
+                actual += points[i * n + j];
+                slope += games[i * n + j] * e * (1.0 - e) * log(10.0) / 400.0;
+            }
+            if (slope <= 0) continue;
+            double step = (actual - expected) / slope;
+            if (step > 100) step = 100;    // Damped, an unbeaten bot would otherwise run away
+            if (step < -100) step = -100;
+            ratings[i] += step;
+            change += fabs(step);
+        }
+        if (change < 1e-6) break;
+    }
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) mean += ratings[i] / n;
+    for (int i = 0; i < n; i++) ratings[i] = ratings[i] - mean + 1500.0;
+}
+void pairTotals(const MatchResult* sample, int count, double* points, double* games) {
+    memset(points, 0, botCount * botCount * sizeof(double));
+    memset(games, 0, botCount * botCount * sizeof(double));
+    for (int m = 0; m < count; m++) {
+        int a = sample[m].left, b = sample[m].right;
+        points[a * botCount + b] += matchScore(&sample[m], 0);
+        points[b * botCount + a] += matchScore(&sample[m], 1);
+        games[a * botCount + b] += 1;
+        games[b * botCount + a] += 1;
+    }
+    for (int i = 0; i < botCount * botCount; i++) {     // One virtual draw per pairing keeps unbeaten ratings finite
+        if (games[i] > 0) {
+            points[i] += 0.5;
+            games[i] += 1;
+        }
+    }
+}
+int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+void swissRound(const double* standing, int round, PongRng* seeds, int gamesPerPairing) { // Pair neighbours in the standings
+    int order[MAX_BOTS];
+    for (int i = 0; i < botCount; i++) order[i] = i;
+    for (int i = 1; i < botCount; i++) {
+        for (int j = i; j > 0 && standing[order[j]] > standing[order[j - 1]]; j--) {
+            int t = order[j]; order[j] = order[j - 1]; order[j - 1] = t;
+        }
+    }
+    int paired = botCount;
+    if (botCount % 2) {     // Odd field: the bye moves up from the bottom of the standings each round
+        int bye = botCount - 1 - round % botCount;
+        for (int i = bye; i + 1 < botCount; i++) order[i] = order[i + 1];
+        paired--;
+    }
+    for (int i = 0; i + 1 < paired; i += 2) {
+        for (int g = 0; g < gamesPerPairing; g++) {
+            if (g % 2 == 0) scheduleMatch(order[i], order[i + 1], seeds);
+            else scheduleMatch(order[i + 1], order[i], seeds);
+        }
+    }
+}
+const Bot* findBot(const char* name) {
+    for (int i = 0; i < BUILTIN_BOT_COUNT; i++) {
+        if (strcmp(builtinBots[i].name, name) == 0) return &builtinBots[i];
+    }
+    printf("Unknown bot %s\n", name);
+    exit(1);
+}
+void selectBots(char* list) { // --bots a,b,c keeps only those, in that order
+    botCount = 0;
+    for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        const Bot* bot = findBot(name);
+        for (int i = 0; i < botCount; i++) {
+            if (bots[i].name == bot->name) {     // Two copies would split one bot's results across two ratings
+                printf("Bot %s is listed twice in --bots\n", name);
+                exit(1);
+            }
+        }
+        if (botCount == MAX_BOTS) {
+            printf("--bots takes at most %d bots\n", MAX_BOTS);
+            exit(1);
+        }
+        bots[botCount++] = *bot;
+    }
+}
+int main(int argc, char* argv[]) {
+    const char* format = "roundrobin";
+    const char* csvPath = NULL;
+    int gamesPerPairing = 100, rounds = 10;
+    int threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = (uint64_t)time(NULL);
+    int replay = 0;
+    MatchResult replayMatch = {0};
+    const Bot* replayLeft = NULL;
+    const Bot* replayRight = NULL;
+    botCount = BUILTIN_BOT_COUNT;
+    memcpy(bots, builtinBots, sizeof(builtinBots));
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) format = argv[++i];
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) gamesPerPairing = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) matchLevel = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvPath = argv[++i];
+        else if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc) selectBots(argv[++i]);
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc && (strcmp(argv[i + 1], "float") == 0 || strcmp(argv[i + 1], "fixed") == 0)) {
+            fixedEngine = strcmp(argv[++i], "fixed") == 0;
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 3 < argc) {     // --replay <match seed> <left bot> <right bot>
+            replay = 1;
+            replayMatch.seed = strtoull(argv[++i], NULL, 0);
+            replayLeft = findBot(argv[++i]);
+            replayRight = findBot(argv[++i]);
+        } else {
+            printf("Usage: %s [--format roundrobin|swiss] [--games N] [--rounds N] [--level 1-3] [--seed S]\n"
+                   "          [--threads N] [--bots a,b,...] [--engine float|fixed] [--csv file] [--replay seed left right]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > 256) threadCount = 256;
+    if (replay) {     // The two bots by name, whatever --bots selected
+        bots[0] = *replayLeft;
+        bots[1] = *replayRight;
+        replayMatch.left = 0;
+        replayMatch.right = 1;
+        runMatch(&replayMatch);
+        printf("%s %d - %d %s on level %d after %ld ticks, %d paddle hits, longest rally %d\n", bots[replayMatch.left].name,
+               replayMatch.leftScore, replayMatch.rightScore, bots[replayMatch.right].name, matchLevel, replayMatch.ticks,
+               replayMatch.paddleHits, replayMatch.longestRally);
+        return 0;
+    }
+    if (botCount < 2) {
+        printf("Need at least two bots\n");
+        return 1;
+    }
+    printf("Tournament seed %llu, %s, level %d, %s engine, %d threads\n", (unsigned long long)seed, format, matchLevel,
+           fixedEngine ? "fixed" : "float", threadCount);
+    PongRng seeds = { seed };
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (strcmp(format, "swiss") == 0) {
+        double standing[MAX_BOTS] = {0};
+        for (int round = 0; round < rounds; round++) {
+            int first = resultCount;
+            swissRound(standing, round, &seeds, gamesPerPairing);
+            runBatch(first, threadCount);
+            for (int m = first; m < resultCount; m++) {
+                standing[results[m].left] += matchScore(&results[m], 0);
+                standing[results[m].right] += matchScore(&results[m], 1);
+            }
+        }
+    } else {
+        for (int a = 0; a < botCount; a++) {
+            for (int b = a + 1; b < botCount; b++) {
+                for (int g = 0; g < gamesPerPairing; g++) {     // Alternate sides
+                    if (g % 2 == 0) scheduleMatch(a, b, &seeds);
+                    else scheduleMatch(b, a, &seeds);
+                }
+            }
+        }
+        runBatch(0, threadCount);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long totalTicks = 0;
+    for (int m = 0; m < resultCount; m++) totalTicks += results[m].ticks;
+    double* points = malloc(botCount * botCount * sizeof(double));
+    double* games = malloc(botCount * botCount * sizeof(double));
+    double* ratings = malloc(botCount * sizeof(double));
+    double* bootstrap = malloc(BOOTSTRAP_SAMPLES * botCount * sizeof(double));
+    MatchResult* sample = malloc(resultCount * sizeof(MatchResult));
+    pairTotals(results, resultCount, points, games);
+    fitElo(points, games, botCount, ratings);
+    PongRng resample = { seed ^ 0xB007 };
+    for (int b = 0; b < BOOTSTRAP_SAMPLES; b++) {     // Resample matches with replacement for the 95% interval
+        double sampleRatings[MAX_BOTS];
+        for (int m = 0; m < resultCount; m++) sample[m] = results[pongRandomValue(&resample, 0, resultCount - 1)];
+        pairTotals(sample, resultCount, points, games);
+        fitElo(points, games, botCount, sampleRatings);
+        for (int i = 0; i < botCount; i++) bootstrap[i * BOOTSTRAP_SAMPLES + b] = sampleRatings[i];
+    }
+    int order[MAX_BOTS];
+    for (int i = 0; i < botCount; i++) order[i] = i;
+    for (int i = 1; i < botCount; i++) {
+        for (int j = i; j > 0 && ratings[order[j]] > ratings[order[j - 1]]; j--) {
+            int t = order[j]; order[j] = order[j - 1]; order[j - 1] = t;
+        }
+    }
+    printf("\n%-10s %6s %15s %6s %6s %6s %7s %9s %10s\n", "Bot", "Elo", "95% CI", "Won", "Lost", "Drawn", "Score", "Ticks/m", "Hits/m");
+    for (int k = 0; k < botCount; k++) {
+        int i = order[k];
+        int won = 0, lost = 0, drawn = 0;
+        long ticks = 0, hits = 0;
+        for (int m = 0; m < resultCount; m++) {
+            int side = (results[m].left == i) ? 0 : (results[m].right == i) ? 1 : -1;
+            if (side < 0) continue;
+            double score = matchScore(&results[m], side);
+            if (score == 1.0) won++;
+            else if (score == 0.0) lost++;
+            else drawn++;
+            ticks += results[m].ticks;
+            hits += results[m].paddleHits;
+        }
+        int played = won + lost + drawn;
+        qsort(&bootstrap[i * BOOTSTRAP_SAMPLES], BOOTSTRAP_SAMPLES, sizeof(double), compareDoubles);
+        printf("%-10s %6.0f  [%5.0f, %5.0f] %6d %6d %6d %6.1f%% %9.0f %10.1f\n", bots[i].name, ratings[i],
+               bootstrap[i * BOOTSTRAP_SAMPLES + BOOTSTRAP_SAMPLES * 25 / 1000],
+               bootstrap[i * BOOTSTRAP_SAMPLES + BOOTSTRAP_SAMPLES * 975 / 1000], won, lost, drawn,
+               played ? 100.0 * (won + 0.5 * drawn) / played : 0.0, played ? (double)ticks / played : 0.0,
+               played ? (double)hits / played : 0.0);
+    }
+    printf("\n%d matches, %ld ticks in %.2f s: %.0f matches/s, %.1f M ticks/s\n", resultCount, totalTicks, seconds,
+           resultCount / seconds, totalTicks / seconds / 1e6);
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            printf("Cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "seed,left,right,level,left_score,right_score,ticks,paddle_hits,longest_rally\n");
+        for (int m = 0; m < resultCount; m++) {
+            fprintf(csv, "%llu,%s,%s,%d,%d,%d,%ld,%d,%d\n", (unsigned long long)results[m].seed, bots[results[m].left].name,
+                    bots[results[m].right].name, matchLevel, results[m].leftScore, results[m].rightScore, results[m].ticks,
+                    results[m].paddleHits, results[m].longestRally);
+        }
+        fclose(csv);
+        printf("Per-match stats written to %s (replay one with --level %d%s --replay <seed> <left> <right>)\n", csvPath,
+               matchLevel, fixedEngine ? " --engine fixed" : "");
+    }
+    free(points);
+    free(games);
+    free(ratings);
+    free(bootstrap);
+    free(sample);
+    free(results);
+    return 0;
+}
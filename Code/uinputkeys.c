@@ -0,0 +1,68 @@
+#include <stdio.h> // Virtual keyboard for PingPong.c --evdev tests: gcc -O2 uinputkeys.c -o uinputkeys, run as root (or with /dev/uinput access)
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+volatile sig_atomic_t stopRequested = 0;
+void handleSignal(int signal) {
+    stopRequested = 1;
+}
+void emit(int fd, int type, int code, int value) { // The kernel stamps the event when it is written
+    struct input_event event = { .type = type, .code = code, .value = value };
+    if (write(fd, &event, sizeof(event)) != sizeof(event)) printf("uinput write: %s\n", strerror(errno));
+}
+void tap(int fd, int key, int holdMs) {
+    emit(fd, EV_KEY, key, 1);
+    emit(fd, EV_SYN, SYN_REPORT, 0);
+    usleep(holdMs * 1000);
+    emit(fd, EV_KEY, key, 0);
+    emit(fd, EV_SYN, SYN_REPORT, 0);
+}
+int main(int argc, char* argv[]) {
+    int presses = 100, holdMs = 100, gapMs = 400, delaySeconds = 5, keyUp = KEY_W, keyDown = KEY_S;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--presses") == 0 && i + 1 < argc) presses = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hold-ms") == 0 && i + 1 < argc) holdMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--gap-ms") == 0 && i + 1 < argc) gapMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) delaySeconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--right") == 0) {     // Up/Down instead of W/S
+            keyUp = KEY_UP;
+            keyDown = KEY_DOWN;
+        }
+        else {
+            printf("Usage: %s [--presses n] [--hold-ms n] [--gap-ms n] [--delay seconds] [--right]\n", argv[0]);
+            return 2;
+        }
+    }
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (fd < 0) {
+        printf("Cannot open /dev/uinput: %s (modprobe uinput, and run as root)\n", strerror(errno));
+        return 1;
+    }
+    ioctl(fd, UI_SET_EVBIT, EV_KEY);
+    int keys[] = { KEY_W, KEY_S, KEY_UP, KEY_DOWN };
+    for (int i = 0; i < 4; i++) ioctl(fd, UI_SET_KEYBIT, keys[i]);
+    struct uinput_setup setup = { .id = { .bustype = BUS_VIRTUAL, .vendor = 0x1981, .product = 0x0001 } };
+    snprintf(setup.name, sizeof(setup.name), "PingPong uinput keys");
+    if (ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+        printf("Cannot create the virtual keyboard: %s\n", strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, handleSignal);
+    printf("Virtual keyboard up. Start the game with --evdev --input-latency and pick a mode within %d s\n", delaySeconds);
+    sleep(delaySeconds);
+    int done = 0;
+    for (; done < presses && !stopRequested; done++) {     // Alternate down and up, so the paddle stays off the walls
+        tap(fd, done % 2 ? keyUp : keyDown, holdMs);
+        usleep(gapMs * 1000);
+    }
+    printf("%d presses sent\n", done);
+    ioctl(fd, UI_DEV_DESTROY);
+    close(fd);
+    return 0;
+}